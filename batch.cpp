@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include "primitives.h"
+
+/*
+ * Batch solver: reads one scramble per line from a file or from stdin and
+ * solves them on nthreads threads, one cube per thread. For each line it
+ * prints index, solution, length and solving time in seconds, separated by
+ * tabs and in the same order as the input. Lines that cannot be parsed get
+ * the solution ERROR and length -1.
+ *
+ * At most WINDOW lines per thread are read ahead of the last line printed,
+ * so that memory stays bounded when one cube takes much longer than the
+ * others.
+ *
+ * A file given on the command line is mapped in memory and parsed one line
+ * at a time with ScrambleStream, the standard input is read line by line.
+ * Both are only read as far as the window allows.
+ *
+ * When the solver is compiled with -DSOLVE_STATS, the search statistics of
+ * each line are printed on stderr.
+ */
+
+#define WINDOW 4
+
+typedef struct {
+    size_t index;
+    bool valid;
+    sol_t moves;
+} job_t;
+
+static mutex batch_lock;
+static condition_variable cv;
+static deque<job_t> jobs;
+static map<size_t, string> results;
+static size_t nwritten = 0;
+static bool eof = false;
+
+static string solve_line(const job_t &job) {
+    char buf[64];
+    if (!job.valid) {
+        fprintf(stderr, "Line %zu: invalid scramble\n", job.index);
+        snprintf(buf, sizeof(buf), "%zu\tERROR\t-1\t0.000\n", job.index);
+        return buf;
+    }
+
+    sol_t mv = job.moves;
+    auto start = chrono::steady_clock::now();
+    solve_result_t r = solve(apply_alg(cube_new(), &mv), solve_options_t());
+    chrono::duration<double> t = chrono::steady_clock::now() - start;
+    const sol_t &sol = r.solution;
+#ifdef SOLVE_STATS
+    {
+        lock_guard<mutex> guard(batch_lock);
+        fprintf(stderr, "Line %zu:\n", job.index);
+        print_solve_stats(stderr, r.stats);
+    }
+#endif
+
+    string ret = to_string(job.index) + "\t" + solution_singmaster(sol);
+    snprintf(buf, sizeof(buf), "\t%zu\t%.3f\n", sol.size(), t.count());
+    return ret + buf;
+}
+
+static void work() {
+    for (;;) {
+        job_t job;
+        {
+            unique_lock<mutex> guard(batch_lock);
+            cv.wait(guard, [] { return eof || !jobs.empty(); });
+            if (jobs.empty())
+                return;
+            job = move(jobs.front());
+            jobs.pop_front();
+        }
+        string out = solve_line(job);
+
+        lock_guard<mutex> guard(batch_lock);
+        results[job.index] = out;
+        for (auto it = results.begin();
+            it != results.end() && it->first == nwritten + 1;
+            it = results.erase(it)) {
+            fputs(it->second.c_str(), stdout);
+            nwritten++;
+        }
+        fflush(stdout);
+        cv.notify_all();
+    }
+}
+
+int main(int argc, char **argv) {
+    int nthreads = 1;
+    const char *filename = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            nthreads = atoi(argv[++i]);
+        else
+            filename = argv[i];
+    }
+    if (nthreads < 1) {
+        fprintf(stderr, "usage: %s [-t threads] [file]\n", argv[0]);
+        return 1;
+    }
+
+    ScrambleStream file;
+    if (filename != NULL && !file.open(filename)) {
+        fprintf(stderr, "Cannot open %s\n", filename);
+        return 1;
+    }
+
+    init_phase1_tables();
+    init_phase2_tables();
+
+    vector<thread> threads;
+    for (int i = 0; i < nthreads; i++)
+        threads.push_back(thread(work));
+
+    string line;
+    for (size_t index = 1; ; index++) {
+        job_t job = {index, true, sol_t()};
+        if (filename != NULL) {
+            if (!file.next(job.moves, job.valid))
+                break;
+        } else {
+            if (!getline(cin, line))
+                break;
+            job.moves.resize(line.size() + 1);
+            int n = cube_readmoves(line.c_str(), job.moves.data());
+            job.valid = n >= 0;
+            job.moves.resize(max(n, 0));
+        }
+        unique_lock<mutex> guard(batch_lock);
+        cv.wait(guard, [&] { return index - nwritten <= (size_t)WINDOW * nthreads; });
+        jobs.push_back(move(job));
+        cv.notify_all();
+    }
+    {
+        lock_guard<mutex> guard(batch_lock);
+        eof = true;
+    }
+    cv.notify_all();
+    for (auto &t : threads)
+        t.join();
+
+    return 0;
+}
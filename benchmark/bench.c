@@ -0,0 +1,387 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../cube.h"
+
+#define NCUBES      64
+#define STRLENMAX   1000
+#define MINTIME     0.2
+
+typedef int64_t (*run_t)(int64_t, int);
+
+static cube_t cubes[NCUBES];
+static cube_rank_t ranks[NCUBES];
+static char strh48[NCUBES][STRLENMAX];
+static char strlst[NCUBES][STRLENMAX];
+static char bulk[2][NCUBES * 88 + 1];
+static size_t bulklen[2];
+static uint8_t stream[CUBE_STREAM_BUFSIZE(NCUBES, 0) + 32];
+static uint8_t streambuf[CUBE_STREAM_BUFSIZE(NCUBES, 0)];
+static size_t streamlen;
+static volatile int64_t sink;
+static double mintime = MINTIME;
+
+static int64_t (*coord[])(cube_t) = {
+	cube_coord_co, cube_coord_eo, cube_coord_eslice,
+	cube_coord_cp, cube_coord_epud, cube_coord_epe,
+	cube_coord_ep, cube_coord_csep, cube_coord_esep
+};
+static const char *coordname[] = {
+	"co", "eo", "eslice", "cp", "epud", "epe", "ep", "csep", "esep"
+};
+
+/*
+ * Each benchmark runs n operations. Operations on a single cube use the
+ * result of the previous one, the others cycle through the random cubes.
+ * The return value only serves to keep the results alive.
+ */
+
+static int64_t
+run_move(int64_t n, int m)
+{
+	int64_t i;
+	cube_t c;
+
+	for (i = 0, c = cubes[0]; i < n; i++)
+		c = cube_move(c, (move_t)m);
+
+	return c.edge[0];
+}
+
+static int64_t
+run_compose(int64_t n, int arg)
+{
+	int64_t i;
+	cube_t c;
+
+	(void)arg;
+	for (i = 0, c = cubes[0]; i < n; i++)
+		c = cube_compose(c, cubes[i % NCUBES]);
+
+	return c.edge[0];
+}
+
+static int64_t
+run_inverse(int64_t n, int arg)
+{
+	int64_t i;
+	cube_t c;
+
+	(void)arg;
+	for (i = 0, c = cubes[0]; i < n; i++)
+		c = cube_inverse(c);
+
+	return c.edge[0];
+}
+
+static int64_t
+run_transform(int64_t n, int t)
+{
+	int64_t i;
+	cube_t c;
+
+	for (i = 0, c = cubes[0]; i < n; i++)
+		c = cube_transform(c, (trans_t)t);
+
+	return c.edge[0];
+}
+
+/* With arg == 2, the 48 calls to cube_transform() it replaces */
+static int64_t
+run_canonical(int64_t n, int arg)
+{
+	int64_t i, s;
+	int t;
+	cube_t c, x, best;
+
+	for (i = 0, s = 0; i < n; i++) {
+		c = cubes[i % NCUBES];
+		if (arg < 2) {
+			best = cube_canonical(c, arg, NULL, NULL);
+		} else {
+			best = c;
+			for (t = 1; t < 48; t++) {
+				x = cube_transform(c, (trans_t)t);
+				if (memcmp(&x, &best, sizeof(cube_t)) < 0)
+					best = x;
+			}
+		}
+		s += best.edge[0];
+	}
+
+	return s;
+}
+
+static int64_t
+run_hash(int64_t n, int arg)
+{
+	int64_t i, s;
+
+	(void)arg;
+	for (i = 0, s = 0; i < n; i++)
+		s += cube_hash(cubes[i % NCUBES]);
+
+	return s;
+}
+
+static int64_t
+run_equal(int64_t n, int arg)
+{
+	int64_t i, s;
+
+	(void)arg;
+	for (i = 0, s = 0; i < n; i++)
+		s += cube_equal(cubes[i % NCUBES], cubes[(i+1) % NCUBES]);
+
+	return s;
+}
+
+static int64_t
+run_coord(int64_t n, int k)
+{
+	int64_t i, s;
+
+	for (i = 0, s = 0; i < n; i++)
+		s += coord[k](cubes[i % NCUBES]);
+
+	return s;
+}
+
+static int64_t
+run_rank(int64_t n, int arg)
+{
+	int64_t i, s;
+
+	(void)arg;
+	for (i = 0, s = 0; i < n; i++)
+		s += cube_rank(cubes[i % NCUBES]).lo;
+
+	return s;
+}
+
+static int64_t
+run_unrank(int64_t n, int arg)
+{
+	int64_t i, s;
+
+	(void)arg;
+	for (i = 0, s = 0; i < n; i++)
+		s += cube_unrank(ranks[i % NCUBES]).edge[0];
+
+	return s;
+}
+
+static int64_t
+run_read(int64_t n, int lst)
+{
+	int64_t i, s;
+
+	for (i = 0, s = 0; i < n; i++)
+		s += lst ?
+		    cube_read("LST", strlst[i % NCUBES]).edge[0] :
+		    cube_read("H48", strh48[i % NCUBES]).edge[0];
+
+	return s;
+}
+
+static int64_t
+run_write(int64_t n, int lst)
+{
+	int64_t i, s;
+	char buf[STRLENMAX];
+
+	for (i = 0, s = 0; i < n; i++) {
+		cube_write(lst ? "LST" : "H48", cubes[i % NCUBES], buf);
+		s += buf[0];
+	}
+
+	return s;
+}
+
+/* Bulk functions, n is rounded up to a multiple of NCUBES */
+static int64_t
+run_readbulk(int64_t n, int lst)
+{
+	int64_t i, s;
+	cube_t c[NCUBES];
+
+	for (i = 0, s = 0; i < n; i += NCUBES) {
+		cube_readbulk(lst ? "LST" : "H48", bulk[lst], bulklen[lst],
+		    NCUBES, c, NULL, NULL);
+		s += c[0].edge[0];
+	}
+
+	return s;
+}
+
+static int64_t
+run_writebulk(int64_t n, int lst)
+{
+	int64_t i, s;
+	char buf[NCUBES * 88 + 1];
+
+	for (i = 0, s = 0; i < n; i += NCUBES)
+		s += cube_writebulk(lst ? "LST" : "H48", cubes, NCUBES, buf, NULL);
+
+	return s;
+}
+
+static size_t
+writestream(const void *data, size_t len, void *arg)
+{
+	(void)arg;
+	memcpy(stream + streamlen, data, len);
+	streamlen += len;
+	return len;
+}
+
+/* A stream with one block of NCUBES cubes, n is rounded up as above */
+static int64_t
+run_writestream(int64_t n, int arg)
+{
+	int64_t i;
+	int j;
+	cube_stream_writer_t w;
+
+	(void)arg;
+	for (i = 0; i < n; i += NCUBES) {
+		streamlen = 0;
+		cube_stream_writer_init(&w, 0, NCUBES, streambuf, writestream,
+		    NULL);
+		for (j = 0; j < NCUBES; j++)
+			cube_stream_write(&w, cubes[j], NULL, 0);
+		cube_stream_writer_close(&w);
+	}
+
+	return streamlen;
+}
+
+static int64_t
+run_readstream(int64_t n, int arg)
+{
+	int64_t i, s;
+	cube_t c;
+	cube_stream_reader_t r;
+
+	(void)arg;
+	for (i = 0, s = 0; i < n; i += NCUBES) {
+		cube_stream_reader_init(&r, stream, streamlen);
+		while (cube_stream_read(&r, &c, NULL, NULL) == 1)
+			s += c.edge[0];
+	}
+
+	return s;
+}
+
+static int64_t
+run_solvable(int64_t n, int arg)
+{
+	int64_t i, s;
+
+	(void)arg;
+	for (i = 0, s = 0; i < n; i++)
+		s += cube_solvable(cubes[i % NCUBES]);
+
+	return s;
+}
+
+static double
+seconds(struct timespec a, struct timespec b)
+{
+	return (b.tv_sec - a.tv_sec) + (b.tv_nsec - a.tv_nsec) / 1e9;
+}
+
+/* Doubles the number of operations until a run takes at least mintime */
+static void
+bench(const char *name, run_t run, int arg)
+{
+	int64_t n;
+	double t;
+	struct timespec start, end;
+
+	for (n = 1; ; n *= 2) {
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		sink = run(n, arg);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		if ((t = seconds(start, end)) >= mintime)
+			break;
+	}
+
+	printf("%-24s %10.2f ns/op %14.0f ops/s\n",
+	    name, t * 1e9 / n, n / t);
+}
+
+static void
+initcubes(void)
+{
+	int i, j;
+	uint64_t r;
+
+	/* 40 pseudo-random moves per cube, always the same ones */
+	for (i = 0, r = 1; i < NCUBES; i++) {
+		cubes[i] = cube_new();
+		for (j = 0; j < 40; j++) {
+			r = r * 6364136223846793005ULL + 1442695040888963407ULL;
+			cubes[i] = cube_move(cubes[i], (move_t)((r >> 33) % 18));
+		}
+		ranks[i] = cube_rank(cubes[i]);
+		cube_write("H48", cubes[i], strh48[i]);
+		cube_write("LST", cubes[i], strlst[i]);
+	}
+	bulklen[0] = cube_writebulk("H48", cubes, NCUBES, bulk[0], NULL);
+	bulklen[1] = cube_writebulk("LST", cubes, NCUBES, bulk[1], NULL);
+	run_writestream(NCUBES, 0);
+}
+
+int
+main(int argc, char **argv)
+{
+	int i;
+	char name[100];
+
+	if (argc > 1)
+		mintime = atof(argv[1]);
+
+	initcubes();
+	printf("Backend: %s\n", cube_backend());
+
+	for (i = 0; i < 18; i++) {
+		sprintf(name, "move %s", cube_movestr((move_t)i));
+		bench(name, run_move, i);
+	}
+	bench("compose", run_compose, 0);
+	bench("inverse", run_inverse, 0);
+	for (i = 0; i < 48; i++) {
+		sprintf(name, "transform %s", cube_transstr((trans_t)i));
+		bench(name, run_transform, i);
+	}
+	bench("canonical", run_canonical, 0);
+	bench("canonical with inverse", run_canonical, 1);
+	bench("canonical by transform", run_canonical, 2);
+	for (i = 0; i < (int)(sizeof(coord) / sizeof(coord[0])); i++) {
+		sprintf(name, "coord %s", coordname[i]);
+		bench(name, run_coord, i);
+	}
+	bench("hash", run_hash, 0);
+	bench("equal", run_equal, 0);
+	bench("rank", run_rank, 0);
+	bench("unrank", run_unrank, 0);
+	bench("read H48", run_read, 0);
+	bench("write H48", run_write, 0);
+	bench("read LST", run_read, 1);
+	bench("write LST", run_write, 1);
+	bench("read bulk H48", run_readbulk, 0);
+	bench("write bulk H48", run_writebulk, 0);
+	bench("read bulk LST", run_readbulk, 1);
+	bench("write bulk LST", run_writebulk, 1);
+	bench("write stream", run_writestream, 0);
+	bench("read stream", run_readstream, 0);
+	bench("solvable", run_solvable, 0);
+
+	return 0;
+}
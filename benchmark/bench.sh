@@ -0,0 +1,12 @@
+#!/bin/sh
+
+CC="cc -std=c99 -pedantic -Wall -Wextra -O3"
+
+BENCHBIN="benchmark/run"
+CUBEOBJ="cube.o"
+
+echo "Benchmarking with CUBETYPE=${CUBETYPE:-CUBE_PORTABLE}"
+
+$CC -o $BENCHBIN benchmark/bench.c $CUBEOBJ || exit 1
+$BENCHBIN ${BENCHTIME}
+rm -rf $BENCHBIN
@@ -0,0 +1,90 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../cubemap.h"
+
+using namespace std;
+
+/*
+ * Benchmark of CubeMap. It inserts n random cubes (2 million by default)
+ * and then looks each of them up, with CubeSet and, for comparison, with a
+ * std::unordered_map keyed by the cubes written in the H48 format. Then the
+ * same cubes are inserted with insert_concurrent() on the given number of
+ * threads.
+ *
+ *   mapbench [-n cubes] [-t threads]
+ */
+
+static double seconds_since(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+    size_t n = 2000000;
+    int nthreads = 4;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            n = strtoull(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            nthreads = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [-n cubes] [-t threads]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    /* Any 64-bit rank is smaller than the number of cubes */
+    mt19937_64 rng(1);
+    vector<cube_t> cubes(n);
+    for (auto &c : cubes) {
+        cube_rank_t r = { 0, rng() };
+        c = cube_unrank(r);
+    }
+
+    auto start = chrono::steady_clock::now();
+    size_t found = 0;
+    CubeSet set;
+    for (auto &c : cubes)
+        set.insert(c);
+    for (auto &c : cubes)
+        found += set.contains(c);
+    printf("CubeSet:             %.3fs (%zu cubes, %zu found)\n",
+        seconds_since(start), set.size(), found);
+
+    start = chrono::steady_clock::now();
+    found = 0;
+    char buf[100];
+    unordered_map<string, bool> strings;
+    for (auto &c : cubes) {
+        cube_write("H48", c, buf);
+        strings[buf] = true;
+    }
+    for (auto &c : cubes) {
+        cube_write("H48", c, buf);
+        found += strings.count(buf);
+    }
+    printf("unordered_map (H48): %.3fs (%zu cubes, %zu found)\n",
+        seconds_since(start), strings.size(), found);
+
+    start = chrono::steady_clock::now();
+    CubeSet shared(n);
+    vector<thread> threads;
+    for (int t = 0; t < nthreads; t++)
+        threads.push_back(thread([&, t] {
+            for (size_t i = t; i < n; i += nthreads)
+                shared.insert_concurrent(cubes[i]);
+        }));
+    for (auto &t : threads)
+        t.join();
+    printf("insert_concurrent:   %.3fs (%zu cubes, %d threads)\n",
+        seconds_since(start), shared.size(), nthreads);
+
+    return 0;
+}
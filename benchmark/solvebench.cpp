@@ -0,0 +1,272 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include "../primitives.h"
+
+/*
+ * Solver benchmark. The first form solves every scramble of the corpus
+ * (benchmark/corpus.txt by default) and writes a JSON report with length,
+ * nodes, time and status of each solve and a summary of the times. The
+ * second form compares two reports and lists the scrambles that got slower
+ * by more than the given percentage (10 by default), or that got a longer
+ * solution or a worse status. It exits with status 1 if there is any
+ * regression, including one in the p99 time.
+ *
+ *   solvebench [-t threads] [-l seconds] [-o report.json] [corpus]
+ *   solvebench -c old.json new.json [-r percent]
+ */
+
+#define DEFAULT_CORPUS "benchmark/corpus.txt"
+#define DEFAULT_LIMIT 10.0
+#define DEFAULT_THRESHOLD 10.0
+
+/* Changes in time smaller than this are noise */
+#define MIN_DIFF 0.002
+
+typedef struct {
+    string category;
+    string name;
+    string scramble;
+    string status;
+    string solution;
+    int length;
+    int64_t nodes;
+    double time;
+} entry_t;
+
+static const char *status_name[] = {
+    "done", "no_solution", "stopped", "node_limit", "time_limit", "unsolvable"
+};
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-t threads] [-l seconds] [-o report.json] [corpus]\n"
+        "       %s -c old.json new.json [-r percent]\n", prog, prog);
+    exit(1);
+}
+
+static vector<entry_t> read_corpus(const char *filename) {
+    vector<entry_t> ret;
+    ifstream in(filename);
+    if (!in) {
+        fprintf(stderr, "Cannot open %s\n", filename);
+        exit(1);
+    }
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+        size_t a = line.find('\t');
+        size_t b = a == string::npos ? a : line.find('\t', a + 1);
+        if (b == string::npos) {
+            fprintf(stderr, "Invalid corpus line: %s\n", line.c_str());
+            exit(1);
+        }
+        entry_t e;
+        e.category = line.substr(0, a);
+        e.name = line.substr(a + 1, b - a - 1);
+        e.scramble = line.substr(b + 1);
+        ret.push_back(e);
+    }
+    return ret;
+}
+
+/* Time at the given percentile, with the nearest-rank method */
+static double percentile(vector<double> t, double p) {
+    if (t.empty())
+        return 0;
+    sort(t.begin(), t.end());
+    size_t k = (size_t)(p / 100.0 * t.size() + 0.999999);
+    return t[max(k, (size_t)1) - 1];
+}
+
+static void write_summary(FILE *f, const char *name, const vector<double> &t, bool last) {
+    double total = 0;
+    for (double x : t)
+        total += x;
+    fprintf(f, "    \"%s\": {\"count\": %zu, \"total\": %.6f, \"p50\": %.6f, "
+        "\"p90\": %.6f, \"p99\": %.6f, \"max\": %.6f}%s\n", name, t.size(), total,
+        percentile(t, 50), percentile(t, 90), percentile(t, 99), percentile(t, 100),
+        last ? "" : ",");
+}
+
+static void write_report(FILE *f, const vector<entry_t> &entries, int nthreads, double limit) {
+    fprintf(f, "{\n  \"backend\": \"%s\",\n  \"threads\": %d,\n  \"time_limit\": %.3f,\n",
+        cube_backend(), nthreads, limit);
+    fprintf(f, "  \"results\": [\n");
+    map<string, vector<double>> bycat;
+    vector<double> all;
+    for (size_t i = 0; i < entries.size(); i++) {
+        const entry_t &e = entries[i];
+        fprintf(f, "    {\"category\": \"%s\", \"name\": \"%s\", \"scramble\": \"%s\", "
+            "\"status\": \"%s\", \"solution\": \"%s\", \"length\": %d, \"nodes\": %lld, "
+            "\"time\": %.6f}%s\n", e.category.c_str(), e.name.c_str(), e.scramble.c_str(),
+            e.status.c_str(), e.solution.c_str(), e.length, (long long)e.nodes, e.time,
+            i + 1 < entries.size() ? "," : "");
+        bycat[e.category].push_back(e.time);
+        all.push_back(e.time);
+    }
+    fprintf(f, "  ],\n  \"summary\": {\n");
+    for (auto &c : bycat)
+        write_summary(f, c.first.c_str(), c.second, false);
+    write_summary(f, "all", all, true);
+    fprintf(f, "  }\n}\n");
+}
+
+static int run(const char *corpus, const char *output, int nthreads, double limit) {
+    vector<entry_t> entries = read_corpus(corpus);
+    solve_options_t opts;
+    opts.nthreads = nthreads;
+    opts.max_time = limit;
+
+    init_phase1_tables();
+    init_phase2_tables();
+    for (auto &e : entries) {
+        vector<move_t> mv(e.scramble.size() + 1);
+        int n = cube_readmoves(e.scramble.c_str(), mv.data());
+        if (n < 0) {
+            fprintf(stderr, "Invalid scramble %s: %s\n", e.name.c_str(), e.scramble.c_str());
+            return 1;
+        }
+        mv.resize(n);
+        cube_t c = apply_alg(cube_new(), &mv);
+
+        auto start = chrono::steady_clock::now();
+        solve_result_t r = solve(c, opts);
+        e.time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        e.status = status_name[r.status];
+        e.solution = solution_singmaster(r.solution);
+        e.length = r.status == SOLVE_DONE || !r.solution.empty() ? (int)r.solution.size() : -1;
+        e.nodes = r.nodes;
+        fprintf(stderr, "%-12s %-12s %3d %12lld %10.3fs\n", e.name.c_str(),
+            e.status.c_str(), e.length, (long long)e.nodes, e.time);
+    }
+
+    FILE *f = output != NULL ? fopen(output, "w") : stdout;
+    if (f == NULL) {
+        fprintf(stderr, "Cannot write %s\n", output);
+        return 1;
+    }
+    write_report(f, entries, nthreads, limit);
+    if (f != stdout)
+        fclose(f);
+    return 0;
+}
+
+/* Value of "key" in a line of a report, for the format written above */
+static string field(const string &line, const char *key) {
+    string k = string("\"") + key + "\": ";
+    size_t a = line.find(k);
+    if (a == string::npos)
+        return "";
+    a += k.size();
+    if (line[a] == '"') {
+        size_t b = line.find('"', a + 1);
+        return line.substr(a + 1, b - a - 1);
+    }
+    size_t b = line.find_first_of(",}", a);
+    return line.substr(a, b - a);
+}
+
+static map<string, entry_t> read_report(const char *filename, double &p99) {
+    map<string, entry_t> ret;
+    ifstream in(filename);
+    if (!in) {
+        fprintf(stderr, "Cannot open %s\n", filename);
+        exit(1);
+    }
+    string line;
+    p99 = 0;
+    while (getline(in, line)) {
+        if (line.find("\"all\": ") != string::npos) {
+            p99 = atof(field(line, "p99").c_str());
+            continue;
+        }
+        if (line.find("\"name\": ") == string::npos)
+            continue;
+        entry_t e;
+        e.category = field(line, "category");
+        e.name = field(line, "name");
+        e.status = field(line, "status");
+        e.length = atoi(field(line, "length").c_str());
+        e.nodes = atoll(field(line, "nodes").c_str());
+        e.time = atof(field(line, "time").c_str());
+        ret[e.name] = e;
+    }
+    return ret;
+}
+
+static bool slower(double old, double cur, double threshold) {
+    return cur - old > MIN_DIFF && cur > old * (1 + threshold / 100);
+}
+
+static int compare(const char *oldfile, const char *newfile, double threshold) {
+    double oldp99, newp99;
+    map<string, entry_t> old = read_report(oldfile, oldp99);
+    map<string, entry_t> cur = read_report(newfile, newp99);
+    int regressions = 0;
+
+    for (auto &it : cur) {
+        auto o = old.find(it.first);
+        if (o == old.end())
+            continue;
+        const entry_t &a = o->second, &b = it.second;
+        const char *what = NULL;
+        if (a.status == "done" && b.status != "done")
+            what = "status";
+        else if (a.length >= 0 && (b.length < 0 || b.length > a.length))
+            what = "length";
+        else if (slower(a.time, b.time, threshold))
+            what = "time";
+        if (what == NULL)
+            continue;
+        printf("REGRESSION %-12s %-6s %s/%d/%.3fs -> %s/%d/%.3fs\n", b.name.c_str(),
+            what, a.status.c_str(), a.length, a.time, b.status.c_str(), b.length, b.time);
+        regressions++;
+    }
+    if (slower(oldp99, newp99, threshold)) {
+        printf("REGRESSION p99 time %.3fs -> %.3fs\n", oldp99, newp99);
+        regressions++;
+    }
+    printf("%d regressions, p99 time %.3fs -> %.3fs\n", regressions, oldp99, newp99);
+    return regressions > 0;
+}
+
+int main(int argc, char **argv) {
+    int nthreads = 1;
+    double limit = DEFAULT_LIMIT, threshold = DEFAULT_THRESHOLD;
+    const char *output = NULL, *corpus = DEFAULT_CORPUS;
+    vector<const char *> cmp;
+    bool comparing = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            nthreads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-l") && i + 1 < argc)
+            limit = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc)
+            output = argv[++i];
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc)
+            threshold = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-c"))
+            comparing = true;
+        else if (argv[i][0] == '-')
+            usage(argv[0]);
+        else if (comparing)
+            cmp.push_back(argv[i]);
+        else
+            corpus = argv[i];
+    }
+
+    if (comparing) {
+        if (cmp.size() != 2)
+            usage(argv[0]);
+        return compare(cmp[0], cmp[1], threshold);
+    }
+    if (nthreads < 1)
+        usage(argv[0]);
+    return run(corpus, output, nthreads, limit);
+}
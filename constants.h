@@ -8,6 +8,9 @@
 #define _12c4  495U
 #define _8c4   70U
 
+/* Solvable cubes without the edge orientation, 8! * 3^7 * 12! / 2 */
+#define _nrank UINT64_C(21119142223872000)
+
 #define _c_ufr      0U
 #define _c_ubl      1U
 #define _c_dfl      2U
@@ -30,6 +33,13 @@
 #define _e_bl       10U
 #define _e_br       11U
 
+#define _face_u     1U
+#define _face_d     2U
+#define _face_r     3U
+#define _face_l     4U
+#define _face_f     5U
+#define _face_b     6U
+
 #define _eoshift    4U
 #define _coshift    5U
 
@@ -45,11 +55,40 @@
 #define _eflip      0x10U
 #define _error      0xFFU
 
+#define _stream_magic       "CUBESTRM"
+#define _stream_version     1U
+#define _stream_header      16U
+#define _stream_blockheader 8U
+#define _stream_cube        13U
+
+_static int64_t binomial[12][12] = {
+	{1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+	{1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+	{1, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+	{1, 3, 3, 1, 0, 0, 0, 0, 0, 0, 0, 0},
+	{1, 4, 6, 4, 1, 0, 0, 0, 0, 0, 0, 0},
+	{1, 5, 10, 10, 5, 1, 0, 0, 0, 0, 0, 0},
+	{1, 6, 15, 20, 15, 6, 1, 0, 0, 0, 0, 0},
+	{1, 7, 21, 35, 35, 21, 7, 1, 0, 0, 0, 0},
+	{1, 8, 28, 56, 70, 56, 28, 8, 1, 0, 0, 0},
+	{1, 9, 36, 84, 126, 126, 84, 36, 9, 1, 0, 0},
+	{1, 10, 45, 120, 210, 252, 210, 120, 45, 10, 1, 0},
+	{1, 11, 55, 165, 330, 462, 462, 330, 165, 55, 11, 1}
+};
+
+_static int64_t factorial[12] = {
+	1, 1, 2, 6, 24, 120, 720, 5040, 40320, 362880, 3628800, 39916800
+};
+
 _static cube_t zero = { .corner = {0}, .edge = {0} };
 _static cube_t solved = {
 	.corner = {0, 1, 2, 3, 4, 5, 6, 7},
 	.edge = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}
 };
+#ifdef DEBUG
+/* Returned by cube_rank() for unsolvable cubes, only checked when debugging */
+_static cube_rank_t rank_error = { .hi = UINT64_MAX, .lo = UINT64_MAX };
+#endif
 
 _static cube_t move_table[] = {
 	[U] = {
@@ -646,6 +685,51 @@ _static char *edgestr[] = {
 	[_e_br] = "BR"
 };
 
+/*
+ * Tables for decoding the pieces of the H48 format: facecode maps the letter
+ * of a face to its code (0 for other characters), and edgecode and
+ * cornercode map the face codes of the stickers of a piece to the piece
+ * plus 1 (0 if there is no such piece). Corners can be written both ways.
+ */
+_static uint8_t facecode[256] = {
+	['U'] = _face_u, ['D'] = _face_d, ['R'] = _face_r,
+	['L'] = _face_l, ['F'] = _face_f, ['B'] = _face_b
+};
+
+_static uint8_t edgecode[7][7] = {
+	[_face_u][_face_f] = _e_uf + 1,
+	[_face_u][_face_b] = _e_ub + 1,
+	[_face_d][_face_b] = _e_db + 1,
+	[_face_d][_face_f] = _e_df + 1,
+	[_face_u][_face_r] = _e_ur + 1,
+	[_face_u][_face_l] = _e_ul + 1,
+	[_face_d][_face_l] = _e_dl + 1,
+	[_face_d][_face_r] = _e_dr + 1,
+	[_face_f][_face_r] = _e_fr + 1,
+	[_face_f][_face_l] = _e_fl + 1,
+	[_face_b][_face_l] = _e_bl + 1,
+	[_face_b][_face_r] = _e_br + 1
+};
+
+_static uint8_t cornercode[7][7][7] = {
+	[_face_u][_face_f][_face_r] = _c_ufr + 1,
+	[_face_u][_face_b][_face_l] = _c_ubl + 1,
+	[_face_d][_face_f][_face_l] = _c_dfl + 1,
+	[_face_d][_face_b][_face_r] = _c_dbr + 1,
+	[_face_u][_face_f][_face_l] = _c_ufl + 1,
+	[_face_u][_face_b][_face_r] = _c_ubr + 1,
+	[_face_d][_face_f][_face_r] = _c_dfr + 1,
+	[_face_d][_face_b][_face_l] = _c_dbl + 1,
+	[_face_u][_face_r][_face_f] = _c_ufr + 1,
+	[_face_u][_face_l][_face_b] = _c_ubl + 1,
+	[_face_d][_face_l][_face_f] = _c_dfl + 1,
+	[_face_d][_face_r][_face_b] = _c_dbr + 1,
+	[_face_u][_face_l][_face_f] = _c_ufl + 1,
+	[_face_u][_face_r][_face_b] = _c_ubr + 1,
+	[_face_d][_face_r][_face_f] = _c_dfr + 1,
+	[_face_d][_face_l][_face_b] = _c_dbl + 1
+};
+
 _static char *movestr[] = {
 	[U]  = "U",
 	[U2] = "U2",
@@ -768,3 +852,1482 @@ static uint8_t inverse_trans_table[48] = {
 	[BLr] = RDr,
 	[BLm] = LDm,
 };
+
+#ifdef CUBE_BACKEND_AVX2
+
+_static uint8_t solved_avx2[32] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 0, 0, 0, 0
+};
+
+_static uint8_t move_table_avx2[][32] = {
+	[U] = {
+		5, 4, 2, 3, 0, 1, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+		4, 5, 2, 3, 1, 0, 6, 7, 8, 9, 10, 11, 0, 0, 0, 0
+	},
+	[U2] = {
+		1, 0, 2, 3, 5, 4, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+		1, 0, 2, 3, 5, 4, 6, 7, 8, 9, 10, 11, 0, 0, 0, 0
+	},
+	[U3] = {
+		4, 5, 2, 3, 1, 0, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+		5, 4, 2, 3, 0, 1, 6, 7, 8, 9, 10, 11, 0, 0, 0, 0
+	},
+	[D] = {
+		0, 1, 7, 6, 4, 5, 2, 3, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 1, 7, 6, 4, 5, 2, 3, 8, 9, 10, 11, 0, 0, 0, 0
+	},
+	[D2] = {
+		0, 1, 3, 2, 4, 5, 7, 6, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 1, 3, 2, 4, 5, 7, 6, 8, 9, 10, 11, 0, 0, 0, 0
+	},
+	[D3] = {
+		0, 1, 6, 7, 4, 5, 3, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 1, 6, 7, 4, 5, 3, 2, 8, 9, 10, 11, 0, 0, 0, 0
+	},
+	[R] = {
+		70, 1, 2, 69, 4, 32, 35, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 1, 2, 3, 8, 5, 6, 11, 7, 9, 10, 4, 0, 0, 0, 0
+	},
+	[R2] = {
+		3, 1, 2, 0, 4, 6, 5, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 1, 2, 3, 7, 5, 6, 4, 11, 9, 10, 8, 0, 0, 0, 0
+	},
+	[R3] = {
+		69, 1, 2, 70, 4, 35, 32, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 1, 2, 3, 11, 5, 6, 8, 4, 9, 10, 7, 0, 0, 0, 0
+	},
+	[L] = {
+		0, 71, 68, 3, 33, 5, 6, 34, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 1, 2, 3, 4, 10, 9, 7, 8, 5, 6, 11, 0, 0, 0, 0
+	},
+	[L2] = {
+		0, 2, 1, 3, 7, 5, 6, 4, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 1, 2, 3, 4, 6, 5, 7, 8, 10, 9, 11, 0, 0, 0, 0
+	},
+	[L3] = {
+		0, 68, 71, 3, 34, 5, 6, 33, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 1, 2, 3, 4, 9, 10, 7, 8, 6, 5, 11, 0, 0, 0, 0
+	},
+	[F] = {
+		36, 1, 38, 3, 66, 5, 64, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+		25, 1, 2, 24, 4, 5, 6, 7, 16, 19, 10, 11, 0, 0, 0, 0
+	},
+	[F2] = {
+		2, 1, 0, 3, 6, 5, 4, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+		3, 1, 2, 0, 4, 5, 6, 7, 9, 8, 10, 11, 0, 0, 0, 0
+	},
+	[F3] = {
+		38, 1, 36, 3, 64, 5, 66, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+		24, 1, 2, 25, 4, 5, 6, 7, 19, 16, 10, 11, 0, 0, 0, 0
+	},
+	[B] = {
+		0, 37, 2, 39, 4, 67, 6, 65, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 27, 26, 3, 4, 5, 6, 7, 8, 9, 17, 18, 0, 0, 0, 0
+	},
+	[B2] = {
+		0, 3, 2, 1, 4, 7, 6, 5, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 2, 1, 3, 4, 5, 6, 7, 8, 9, 11, 10, 0, 0, 0, 0
+	},
+	[B3] = {
+		0, 39, 2, 37, 4, 65, 6, 67, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 26, 27, 3, 4, 5, 6, 7, 8, 9, 18, 17, 0, 0, 0, 0
+	},
+};
+
+_static uint8_t trans_table_avx2[][2][32] = {
+	[UFr] = {
+		[NORMAL] = {
+			0, 1, 2, 3, 4, 5, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			0, 1, 2, 3, 4, 5, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 0, 0, 0, 0
+		}
+	},
+	[ULr] = {
+		[NORMAL] = {
+			4, 5, 7, 6, 1, 0, 2, 3, 0, 0, 0, 0, 0, 0, 0, 0,
+			5, 4, 7, 6, 0, 1, 2, 3, 25, 26, 27, 24, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			5, 4, 6, 7, 0, 1, 3, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+			4, 5, 6, 7, 1, 0, 3, 2, 27, 24, 25, 26, 0, 0, 0, 0
+		}
+	},
+	[UBr] = {
+		[NORMAL] = {
+			1, 0, 3, 2, 5, 4, 7, 6, 0, 0, 0, 0, 0, 0, 0, 0,
+			1, 0, 3, 2, 5, 4, 7, 6, 10, 11, 8, 9, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			1, 0, 3, 2, 5, 4, 7, 6, 0, 0, 0, 0, 0, 0, 0, 0,
+			1, 0, 3, 2, 5, 4, 7, 6, 10, 11, 8, 9, 0, 0, 0, 0
+		}
+	},
+	[URr] = {
+		[NORMAL] = {
+			5, 4, 6, 7, 0, 1, 3, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+			4, 5, 6, 7, 1, 0, 3, 2, 27, 24, 25, 26, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			4, 5, 7, 6, 1, 0, 2, 3, 0, 0, 0, 0, 0, 0, 0, 0,
+			5, 4, 7, 6, 0, 1, 2, 3, 25, 26, 27, 24, 0, 0, 0, 0
+		}
+	},
+	[DFr] = {
+		[NORMAL] = {
+			2, 3, 0, 1, 6, 7, 4, 5, 0, 0, 0, 0, 0, 0, 0, 0,
+			3, 2, 1, 0, 6, 7, 4, 5, 9, 8, 11, 10, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			2, 3, 0, 1, 6, 7, 4, 5, 0, 0, 0, 0, 0, 0, 0, 0,
+			3, 2, 1, 0, 6, 7, 4, 5, 9, 8, 11, 10, 0, 0, 0, 0
+		}
+	},
+	[DLr] = {
+		[NORMAL] = {
+			7, 6, 4, 5, 2, 3, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			6, 7, 4, 5, 2, 3, 0, 1, 26, 25, 24, 27, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			7, 6, 4, 5, 2, 3, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			6, 7, 4, 5, 2, 3, 0, 1, 26, 25, 24, 27, 0, 0, 0, 0
+		}
+	},
+	[DBr] = {
+		[NORMAL] = {
+			3, 2, 1, 0, 7, 6, 5, 4, 0, 0, 0, 0, 0, 0, 0, 0,
+			2, 3, 0, 1, 7, 6, 5, 4, 11, 10, 9, 8, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			3, 2, 1, 0, 7, 6, 5, 4, 0, 0, 0, 0, 0, 0, 0, 0,
+			2, 3, 0, 1, 7, 6, 5, 4, 11, 10, 9, 8, 0, 0, 0, 0
+		}
+	},
+	[DRr] = {
+		[NORMAL] = {
+			6, 7, 5, 4, 3, 2, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+			7, 6, 5, 4, 3, 2, 1, 0, 24, 27, 26, 25, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			6, 7, 5, 4, 3, 2, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+			7, 6, 5, 4, 3, 2, 1, 0, 24, 27, 26, 25, 0, 0, 0, 0
+		}
+	},
+	[RUr] = {
+		[NORMAL] = {
+			64, 67, 65, 66, 37, 38, 36, 39, 0, 0, 0, 0, 0, 0, 0, 0,
+			20, 23, 22, 21, 24, 27, 26, 25, 0, 1, 2, 3, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			32, 34, 35, 33, 70, 68, 69, 71, 0, 0, 0, 0, 0, 0, 0, 0,
+			8, 9, 10, 11, 16, 19, 18, 17, 20, 23, 22, 21, 0, 0, 0, 0
+		}
+	},
+	[RFr] = {
+		[NORMAL] = {
+			38, 37, 36, 39, 64, 67, 66, 65, 0, 0, 0, 0, 0, 0, 0, 0,
+			24, 27, 26, 25, 23, 20, 21, 22, 19, 16, 17, 18, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			36, 39, 38, 37, 66, 65, 64, 67, 0, 0, 0, 0, 0, 0, 0, 0,
+			25, 26, 27, 24, 21, 22, 23, 20, 16, 19, 18, 17, 0, 0, 0, 0
+		}
+	},
+	[RDr] = {
+		[NORMAL] = {
+			67, 64, 66, 65, 38, 37, 39, 36, 0, 0, 0, 0, 0, 0, 0, 0,
+			23, 20, 21, 22, 27, 24, 25, 26, 2, 3, 0, 1, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			33, 35, 34, 32, 71, 69, 68, 70, 0, 0, 0, 0, 0, 0, 0, 0,
+			10, 11, 8, 9, 17, 18, 19, 16, 21, 22, 23, 20, 0, 0, 0, 0
+		}
+	},
+	[RBr] = {
+		[NORMAL] = {
+			37, 38, 39, 36, 67, 64, 65, 66, 0, 0, 0, 0, 0, 0, 0, 0,
+			27, 24, 25, 26, 20, 23, 22, 21, 17, 18, 19, 16, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			37, 38, 39, 36, 67, 64, 65, 66, 0, 0, 0, 0, 0, 0, 0, 0,
+			27, 24, 25, 26, 20, 23, 22, 21, 17, 18, 19, 16, 0, 0, 0, 0
+		}
+	},
+	[LUr] = {
+		[NORMAL] = {
+			65, 66, 64, 67, 36, 39, 37, 38, 0, 0, 0, 0, 0, 0, 0, 0,
+			21, 22, 23, 20, 26, 25, 24, 27, 1, 0, 3, 2, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			34, 32, 33, 35, 68, 70, 71, 69, 0, 0, 0, 0, 0, 0, 0, 0,
+			9, 8, 11, 10, 19, 16, 17, 18, 22, 21, 20, 23, 0, 0, 0, 0
+		}
+	},
+	[LFr] = {
+		[NORMAL] = {
+			36, 39, 38, 37, 66, 65, 64, 67, 0, 0, 0, 0, 0, 0, 0, 0,
+			25, 26, 27, 24, 21, 22, 23, 20, 16, 19, 18, 17, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			38, 37, 36, 39, 64, 67, 66, 65, 0, 0, 0, 0, 0, 0, 0, 0,
+			24, 27, 26, 25, 23, 20, 21, 22, 19, 16, 17, 18, 0, 0, 0, 0
+		}
+	},
+	[LDr] = {
+		[NORMAL] = {
+			66, 65, 67, 64, 39, 36, 38, 37, 0, 0, 0, 0, 0, 0, 0, 0,
+			22, 21, 20, 23, 25, 26, 27, 24, 3, 2, 1, 0, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			35, 33, 32, 34, 69, 71, 70, 68, 0, 0, 0, 0, 0, 0, 0, 0,
+			11, 10, 9, 8, 18, 17, 16, 19, 23, 20, 21, 22, 0, 0, 0, 0
+		}
+	},
+	[LBr] = {
+		[NORMAL] = {
+			39, 36, 37, 38, 65, 66, 67, 64, 0, 0, 0, 0, 0, 0, 0, 0,
+			26, 25, 24, 27, 22, 21, 20, 23, 18, 17, 16, 19, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			39, 36, 37, 38, 65, 66, 67, 64, 0, 0, 0, 0, 0, 0, 0, 0,
+			26, 25, 24, 27, 22, 21, 20, 23, 18, 17, 16, 19, 0, 0, 0, 0
+		}
+	},
+	[FUr] = {
+		[NORMAL] = {
+			68, 70, 69, 71, 32, 34, 33, 35, 0, 0, 0, 0, 0, 0, 0, 0,
+			16, 19, 18, 17, 9, 8, 11, 10, 5, 4, 7, 6, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			68, 70, 69, 71, 32, 34, 33, 35, 0, 0, 0, 0, 0, 0, 0, 0,
+			16, 19, 18, 17, 9, 8, 11, 10, 5, 4, 7, 6, 0, 0, 0, 0
+		}
+	},
+	[FRr] = {
+		[NORMAL] = {
+			32, 34, 35, 33, 70, 68, 69, 71, 0, 0, 0, 0, 0, 0, 0, 0,
+			8, 9, 10, 11, 16, 19, 18, 17, 20, 23, 22, 21, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			64, 67, 65, 66, 37, 38, 36, 39, 0, 0, 0, 0, 0, 0, 0, 0,
+			20, 23, 22, 21, 24, 27, 26, 25, 0, 1, 2, 3, 0, 0, 0, 0
+		}
+	},
+	[FDr] = {
+		[NORMAL] = {
+			70, 68, 71, 69, 34, 32, 35, 33, 0, 0, 0, 0, 0, 0, 0, 0,
+			19, 16, 17, 18, 8, 9, 10, 11, 7, 6, 5, 4, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			69, 71, 68, 70, 33, 35, 32, 34, 0, 0, 0, 0, 0, 0, 0, 0,
+			17, 18, 19, 16, 11, 10, 9, 8, 4, 5, 6, 7, 0, 0, 0, 0
+		}
+	},
+	[FLr] = {
+		[NORMAL] = {
+			34, 32, 33, 35, 68, 70, 71, 69, 0, 0, 0, 0, 0, 0, 0, 0,
+			9, 8, 11, 10, 19, 16, 17, 18, 22, 21, 20, 23, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			65, 66, 64, 67, 36, 39, 37, 38, 0, 0, 0, 0, 0, 0, 0, 0,
+			21, 22, 23, 20, 26, 25, 24, 27, 1, 0, 3, 2, 0, 0, 0, 0
+		}
+	},
+	[BUr] = {
+		[NORMAL] = {
+			69, 71, 68, 70, 33, 35, 32, 34, 0, 0, 0, 0, 0, 0, 0, 0,
+			17, 18, 19, 16, 11, 10, 9, 8, 4, 5, 6, 7, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			70, 68, 71, 69, 34, 32, 35, 33, 0, 0, 0, 0, 0, 0, 0, 0,
+			19, 16, 17, 18, 8, 9, 10, 11, 7, 6, 5, 4, 0, 0, 0, 0
+		}
+	},
+	[BRr] = {
+		[NORMAL] = {
+			35, 33, 32, 34, 69, 71, 70, 68, 0, 0, 0, 0, 0, 0, 0, 0,
+			11, 10, 9, 8, 18, 17, 16, 19, 23, 20, 21, 22, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			66, 65, 67, 64, 39, 36, 38, 37, 0, 0, 0, 0, 0, 0, 0, 0,
+			22, 21, 20, 23, 25, 26, 27, 24, 3, 2, 1, 0, 0, 0, 0, 0
+		}
+	},
+	[BDr] = {
+		[NORMAL] = {
+			71, 69, 70, 68, 35, 33, 34, 32, 0, 0, 0, 0, 0, 0, 0, 0,
+			18, 17, 16, 19, 10, 11, 8, 9, 6, 7, 4, 5, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			71, 69, 70, 68, 35, 33, 34, 32, 0, 0, 0, 0, 0, 0, 0, 0,
+			18, 17, 16, 19, 10, 11, 8, 9, 6, 7, 4, 5, 0, 0, 0, 0
+		}
+	},
+	[BLr] = {
+		[NORMAL] = {
+			33, 35, 34, 32, 71, 69, 68, 70, 0, 0, 0, 0, 0, 0, 0, 0,
+			10, 11, 8, 9, 17, 18, 19, 16, 21, 22, 23, 20, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			67, 64, 66, 65, 38, 37, 39, 36, 0, 0, 0, 0, 0, 0, 0, 0,
+			23, 20, 21, 22, 27, 24, 25, 26, 2, 3, 0, 1, 0, 0, 0, 0
+		}
+	},
+	[UFm] = {
+		[NORMAL] = {
+			4, 5, 6, 7, 0, 1, 2, 3, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 1, 2, 3, 5, 4, 7, 6, 9, 8, 11, 10, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			4, 5, 6, 7, 0, 1, 2, 3, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 1, 2, 3, 5, 4, 7, 6, 9, 8, 11, 10, 0, 0, 0, 0
+		}
+	},
+	[ULm] = {
+		[NORMAL] = {
+			0, 1, 3, 2, 5, 4, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+			4, 5, 6, 7, 0, 1, 2, 3, 24, 27, 26, 25, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			0, 1, 3, 2, 5, 4, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0,
+			4, 5, 6, 7, 0, 1, 2, 3, 24, 27, 26, 25, 0, 0, 0, 0
+		}
+	},
+	[UBm] = {
+		[NORMAL] = {
+			5, 4, 7, 6, 1, 0, 3, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+			1, 0, 3, 2, 4, 5, 6, 7, 11, 10, 9, 8, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			5, 4, 7, 6, 1, 0, 3, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+			1, 0, 3, 2, 4, 5, 6, 7, 11, 10, 9, 8, 0, 0, 0, 0
+		}
+	},
+	[URm] = {
+		[NORMAL] = {
+			1, 0, 2, 3, 4, 5, 7, 6, 0, 0, 0, 0, 0, 0, 0, 0,
+			5, 4, 7, 6, 1, 0, 3, 2, 26, 25, 24, 27, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			1, 0, 2, 3, 4, 5, 7, 6, 0, 0, 0, 0, 0, 0, 0, 0,
+			5, 4, 7, 6, 1, 0, 3, 2, 26, 25, 24, 27, 0, 0, 0, 0
+		}
+	},
+	[DFm] = {
+		[NORMAL] = {
+			6, 7, 4, 5, 2, 3, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+			3, 2, 1, 0, 7, 6, 5, 4, 8, 9, 10, 11, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			6, 7, 4, 5, 2, 3, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+			3, 2, 1, 0, 7, 6, 5, 4, 8, 9, 10, 11, 0, 0, 0, 0
+		}
+	},
+	[DLm] = {
+		[NORMAL] = {
+			3, 2, 0, 1, 6, 7, 5, 4, 0, 0, 0, 0, 0, 0, 0, 0,
+			7, 6, 5, 4, 2, 3, 0, 1, 27, 24, 25, 26, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			2, 3, 1, 0, 7, 6, 4, 5, 0, 0, 0, 0, 0, 0, 0, 0,
+			6, 7, 4, 5, 3, 2, 1, 0, 25, 26, 27, 24, 0, 0, 0, 0
+		}
+	},
+	[DBm] = {
+		[NORMAL] = {
+			7, 6, 5, 4, 3, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			7, 6, 5, 4, 3, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 0, 0, 0, 0
+		}
+	},
+	[DRm] = {
+		[NORMAL] = {
+			2, 3, 1, 0, 7, 6, 4, 5, 0, 0, 0, 0, 0, 0, 0, 0,
+			6, 7, 4, 5, 3, 2, 1, 0, 25, 26, 27, 24, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			3, 2, 0, 1, 6, 7, 5, 4, 0, 0, 0, 0, 0, 0, 0, 0,
+			7, 6, 5, 4, 2, 3, 0, 1, 27, 24, 25, 26, 0, 0, 0, 0
+		}
+	},
+	[RUm] = {
+		[NORMAL] = {
+			68, 71, 69, 70, 33, 34, 32, 35, 0, 0, 0, 0, 0, 0, 0, 0,
+			21, 22, 23, 20, 25, 26, 27, 24, 0, 1, 2, 3, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			70, 68, 69, 71, 32, 34, 35, 33, 0, 0, 0, 0, 0, 0, 0, 0,
+			8, 9, 10, 11, 19, 16, 17, 18, 23, 20, 21, 22, 0, 0, 0, 0
+		}
+	},
+	[RFm] = {
+		[NORMAL] = {
+			34, 33, 32, 35, 68, 71, 70, 69, 0, 0, 0, 0, 0, 0, 0, 0,
+			25, 26, 27, 24, 22, 21, 20, 23, 19, 16, 17, 18, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			66, 65, 64, 67, 36, 39, 38, 37, 0, 0, 0, 0, 0, 0, 0, 0,
+			25, 26, 27, 24, 22, 21, 20, 23, 19, 16, 17, 18, 0, 0, 0, 0
+		}
+	},
+	[RDm] = {
+		[NORMAL] = {
+			71, 68, 70, 69, 34, 33, 35, 32, 0, 0, 0, 0, 0, 0, 0, 0,
+			22, 21, 20, 23, 26, 25, 24, 27, 2, 3, 0, 1, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			71, 69, 68, 70, 33, 35, 34, 32, 0, 0, 0, 0, 0, 0, 0, 0,
+			10, 11, 8, 9, 18, 17, 16, 19, 22, 21, 20, 23, 0, 0, 0, 0
+		}
+	},
+	[RBm] = {
+		[NORMAL] = {
+			33, 34, 35, 32, 71, 68, 69, 70, 0, 0, 0, 0, 0, 0, 0, 0,
+			26, 25, 24, 27, 21, 22, 23, 20, 17, 18, 19, 16, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			67, 64, 65, 66, 37, 38, 39, 36, 0, 0, 0, 0, 0, 0, 0, 0,
+			27, 24, 25, 26, 23, 20, 21, 22, 18, 17, 16, 19, 0, 0, 0, 0
+		}
+	},
+	[LUm] = {
+		[NORMAL] = {
+			69, 70, 68, 71, 32, 35, 33, 34, 0, 0, 0, 0, 0, 0, 0, 0,
+			20, 23, 22, 21, 27, 24, 25, 26, 1, 0, 3, 2, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			68, 70, 71, 69, 34, 32, 33, 35, 0, 0, 0, 0, 0, 0, 0, 0,
+			9, 8, 11, 10, 16, 19, 18, 17, 21, 22, 23, 20, 0, 0, 0, 0
+		}
+	},
+	[LFm] = {
+		[NORMAL] = {
+			32, 35, 34, 33, 70, 69, 68, 71, 0, 0, 0, 0, 0, 0, 0, 0,
+			24, 27, 26, 25, 20, 23, 22, 21, 16, 19, 18, 17, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			64, 67, 66, 65, 38, 37, 36, 39, 0, 0, 0, 0, 0, 0, 0, 0,
+			24, 27, 26, 25, 20, 23, 22, 21, 16, 19, 18, 17, 0, 0, 0, 0
+		}
+	},
+	[LDm] = {
+		[NORMAL] = {
+			70, 69, 71, 68, 35, 32, 34, 33, 0, 0, 0, 0, 0, 0, 0, 0,
+			23, 20, 21, 22, 24, 27, 26, 25, 3, 2, 1, 0, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			69, 71, 70, 68, 35, 33, 32, 34, 0, 0, 0, 0, 0, 0, 0, 0,
+			11, 10, 9, 8, 17, 18, 19, 16, 20, 23, 22, 21, 0, 0, 0, 0
+		}
+	},
+	[LBm] = {
+		[NORMAL] = {
+			35, 32, 33, 34, 69, 70, 71, 68, 0, 0, 0, 0, 0, 0, 0, 0,
+			27, 24, 25, 26, 23, 20, 21, 22, 18, 17, 16, 19, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			65, 66, 67, 64, 39, 36, 37, 38, 0, 0, 0, 0, 0, 0, 0, 0,
+			26, 25, 24, 27, 21, 22, 23, 20, 17, 18, 19, 16, 0, 0, 0, 0
+		}
+	},
+	[FUm] = {
+		[NORMAL] = {
+			64, 66, 65, 67, 36, 38, 37, 39, 0, 0, 0, 0, 0, 0, 0, 0,
+			16, 19, 18, 17, 8, 9, 10, 11, 4, 5, 6, 7, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			32, 34, 33, 35, 68, 70, 69, 71, 0, 0, 0, 0, 0, 0, 0, 0,
+			16, 19, 18, 17, 8, 9, 10, 11, 4, 5, 6, 7, 0, 0, 0, 0
+		}
+	},
+	[FRm] = {
+		[NORMAL] = {
+			36, 38, 39, 37, 66, 64, 65, 67, 0, 0, 0, 0, 0, 0, 0, 0,
+			9, 8, 11, 10, 16, 19, 18, 17, 21, 22, 23, 20, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			37, 38, 36, 39, 64, 67, 65, 66, 0, 0, 0, 0, 0, 0, 0, 0,
+			20, 23, 22, 21, 27, 24, 25, 26, 1, 0, 3, 2, 0, 0, 0, 0
+		}
+	},
+	[FDm] = {
+		[NORMAL] = {
+			66, 64, 67, 65, 38, 36, 39, 37, 0, 0, 0, 0, 0, 0, 0, 0,
+			19, 16, 17, 18, 9, 8, 11, 10, 6, 7, 4, 5, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			33, 35, 32, 34, 69, 71, 68, 70, 0, 0, 0, 0, 0, 0, 0, 0,
+			17, 18, 19, 16, 10, 11, 8, 9, 5, 4, 7, 6, 0, 0, 0, 0
+		}
+	},
+	[FLm] = {
+		[NORMAL] = {
+			38, 36, 37, 39, 64, 66, 67, 65, 0, 0, 0, 0, 0, 0, 0, 0,
+			8, 9, 10, 11, 19, 16, 17, 18, 23, 20, 21, 22, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			36, 39, 37, 38, 65, 66, 64, 67, 0, 0, 0, 0, 0, 0, 0, 0,
+			21, 22, 23, 20, 25, 26, 27, 24, 0, 1, 2, 3, 0, 0, 0, 0
+		}
+	},
+	[BUm] = {
+		[NORMAL] = {
+			65, 67, 64, 66, 37, 39, 36, 38, 0, 0, 0, 0, 0, 0, 0, 0,
+			17, 18, 19, 16, 10, 11, 8, 9, 5, 4, 7, 6, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			34, 32, 35, 33, 70, 68, 71, 69, 0, 0, 0, 0, 0, 0, 0, 0,
+			19, 16, 17, 18, 9, 8, 11, 10, 6, 7, 4, 5, 0, 0, 0, 0
+		}
+	},
+	[BRm] = {
+		[NORMAL] = {
+			39, 37, 36, 38, 65, 67, 66, 64, 0, 0, 0, 0, 0, 0, 0, 0,
+			10, 11, 8, 9, 18, 17, 16, 19, 22, 21, 20, 23, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			39, 36, 38, 37, 66, 65, 67, 64, 0, 0, 0, 0, 0, 0, 0, 0,
+			22, 21, 20, 23, 26, 25, 24, 27, 2, 3, 0, 1, 0, 0, 0, 0
+		}
+	},
+	[BDm] = {
+		[NORMAL] = {
+			67, 65, 66, 64, 39, 37, 38, 36, 0, 0, 0, 0, 0, 0, 0, 0,
+			18, 17, 16, 19, 11, 10, 9, 8, 7, 6, 5, 4, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			35, 33, 34, 32, 71, 69, 70, 68, 0, 0, 0, 0, 0, 0, 0, 0,
+			18, 17, 16, 19, 11, 10, 9, 8, 7, 6, 5, 4, 0, 0, 0, 0
+		}
+	},
+	[BLm] = {
+		[NORMAL] = {
+			37, 39, 38, 36, 67, 65, 64, 66, 0, 0, 0, 0, 0, 0, 0, 0,
+			11, 10, 9, 8, 17, 18, 19, 16, 20, 23, 22, 21, 0, 0, 0, 0
+		},
+		[INVERSE] = {
+			38, 37, 39, 36, 67, 64, 66, 65, 0, 0, 0, 0, 0, 0, 0, 0,
+			23, 20, 21, 22, 24, 27, 26, 25, 3, 2, 1, 0, 0, 0, 0, 0
+		}
+	},
+};
+
+#endif
+
+#ifdef CUBE_BACKEND_SWAR
+
+_static cube_swar_t solved_swar = {
+	.corner = UINT64_C(0x0706050403020100),
+	.edge = {
+		UINT64_C(0x0706050403020100),
+		UINT64_C(0x000000000B0A0908)
+	}
+};
+
+_static cube_swar_t move_table_swar[] = {
+	[U] = {
+		.corner = UINT64_C(0x0706010003020405),
+		.edge = {
+			UINT64_C(0x0706000103020504),
+			UINT64_C(0x000000000B0A0908)
+		}
+	},
+	[U2] = {
+		.corner = UINT64_C(0x0706040503020001),
+		.edge = {
+			UINT64_C(0x0706040503020001),
+			UINT64_C(0x000000000B0A0908)
+		}
+	},
+	[U3] = {
+		.corner = UINT64_C(0x0706000103020504),
+		.edge = {
+			UINT64_C(0x0706010003020405),
+			UINT64_C(0x000000000B0A0908)
+		}
+	},
+	[D] = {
+		.corner = UINT64_C(0x0302050406070100),
+		.edge = {
+			UINT64_C(0x0302050406070100),
+			UINT64_C(0x000000000B0A0908)
+		}
+	},
+	[D2] = {
+		.corner = UINT64_C(0x0607050402030100),
+		.edge = {
+			UINT64_C(0x0607050402030100),
+			UINT64_C(0x000000000B0A0908)
+		}
+	},
+	[D3] = {
+		.corner = UINT64_C(0x0203050407060100),
+		.edge = {
+			UINT64_C(0x0203050407060100),
+			UINT64_C(0x000000000B0A0908)
+		}
+	},
+	[R] = {
+		.corner = UINT64_C(0x0723200445020146),
+		.edge = {
+			UINT64_C(0x0B06050803020100),
+			UINT64_C(0x00000000040A0907)
+		}
+	},
+	[R2] = {
+		.corner = UINT64_C(0x0705060400020103),
+		.edge = {
+			UINT64_C(0x0406050703020100),
+			UINT64_C(0x00000000080A090B)
+		}
+	},
+	[R3] = {
+		.corner = UINT64_C(0x0720230446020145),
+		.edge = {
+			UINT64_C(0x0806050B03020100),
+			UINT64_C(0x00000000070A0904)
+		}
+	},
+	[L] = {
+		.corner = UINT64_C(0x2206052103444700),
+		.edge = {
+			UINT64_C(0x07090A0403020100),
+			UINT64_C(0x000000000B060508)
+		}
+	},
+	[L2] = {
+		.corner = UINT64_C(0x0406050703010200),
+		.edge = {
+			UINT64_C(0x0705060403020100),
+			UINT64_C(0x000000000B090A08)
+		}
+	},
+	[L3] = {
+		.corner = UINT64_C(0x2106052203474400),
+		.edge = {
+			UINT64_C(0x070A090403020100),
+			UINT64_C(0x000000000B050608)
+		}
+	},
+	[F] = {
+		.corner = UINT64_C(0x0740054203260124),
+		.edge = {
+			UINT64_C(0x0706050418020119),
+			UINT64_C(0x000000000B0A1310)
+		}
+	},
+	[F2] = {
+		.corner = UINT64_C(0x0704050603000102),
+		.edge = {
+			UINT64_C(0x0706050400020103),
+			UINT64_C(0x000000000B0A0809)
+		}
+	},
+	[F3] = {
+		.corner = UINT64_C(0x0742054003240126),
+		.edge = {
+			UINT64_C(0x0706050419020118),
+			UINT64_C(0x000000000B0A1013)
+		}
+	},
+	[B] = {
+		.corner = UINT64_C(0x4106430427022500),
+		.edge = {
+			UINT64_C(0x07060504031A1B00),
+			UINT64_C(0x0000000012110908)
+		}
+	},
+	[B2] = {
+		.corner = UINT64_C(0x0506070401020300),
+		.edge = {
+			UINT64_C(0x0706050403010200),
+			UINT64_C(0x000000000A0B0908)
+		}
+	},
+	[B3] = {
+		.corner = UINT64_C(0x4306410425022700),
+		.edge = {
+			UINT64_C(0x07060504031B1A00),
+			UINT64_C(0x0000000011120908)
+		}
+	},
+};
+
+_static cube_swar_t trans_table_swar[][2] = {
+	[UFr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0706050403020100),
+			.edge = {
+				UINT64_C(0x0706050403020100),
+				UINT64_C(0x000000000B0A0908)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0706050403020100),
+			.edge = {
+				UINT64_C(0x0706050403020100),
+				UINT64_C(0x000000000B0A0908)
+			}
+		}
+	},
+	[ULr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0302000106070504),
+			.edge = {
+				UINT64_C(0x0302010006070405),
+				UINT64_C(0x00000000181B1A19)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0203010007060405),
+			.edge = {
+				UINT64_C(0x0203000107060504),
+				UINT64_C(0x000000001A19181B)
+			}
+		}
+	},
+	[UBr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0607040502030001),
+			.edge = {
+				UINT64_C(0x0607040502030001),
+				UINT64_C(0x0000000009080B0A)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0607040502030001),
+			.edge = {
+				UINT64_C(0x0607040502030001),
+				UINT64_C(0x0000000009080B0A)
+			}
+		}
+	},
+	[URr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0203010007060405),
+			.edge = {
+				UINT64_C(0x0203000107060504),
+				UINT64_C(0x000000001A19181B)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0302000106070504),
+			.edge = {
+				UINT64_C(0x0302010006070405),
+				UINT64_C(0x00000000181B1A19)
+			}
+		}
+	},
+	[DFr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0504070601000302),
+			.edge = {
+				UINT64_C(0x0504070600010203),
+				UINT64_C(0x000000000A0B0809)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0504070601000302),
+			.edge = {
+				UINT64_C(0x0504070600010203),
+				UINT64_C(0x000000000A0B0809)
+			}
+		}
+	},
+	[DLr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0001030205040607),
+			.edge = {
+				UINT64_C(0x0100030205040706),
+				UINT64_C(0x000000001B18191A)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0001030205040607),
+			.edge = {
+				UINT64_C(0x0100030205040706),
+				UINT64_C(0x000000001B18191A)
+			}
+		}
+	},
+	[DBr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0405060700010203),
+			.edge = {
+				UINT64_C(0x0405060701000302),
+				UINT64_C(0x0000000008090A0B)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0405060700010203),
+			.edge = {
+				UINT64_C(0x0405060701000302),
+				UINT64_C(0x0000000008090A0B)
+			}
+		}
+	},
+	[DRr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0100020304050706),
+			.edge = {
+				UINT64_C(0x0001020304050607),
+				UINT64_C(0x00000000191A1B18)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0100020304050706),
+			.edge = {
+				UINT64_C(0x0001020304050607),
+				UINT64_C(0x00000000191A1B18)
+			}
+		}
+	},
+	[RUr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2724262542414340),
+			.edge = {
+				UINT64_C(0x191A1B1815161714),
+				UINT64_C(0x0000000003020100)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4745444621232220),
+			.edge = {
+				UINT64_C(0x111213100B0A0908),
+				UINT64_C(0x0000000015161714)
+			}
+		}
+	},
+	[RFr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4142434027242526),
+			.edge = {
+				UINT64_C(0x16151417191A1B18),
+				UINT64_C(0x0000000012111013)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4340414225262724),
+			.edge = {
+				UINT64_C(0x14171615181B1A19),
+				UINT64_C(0x0000000011121310)
+			}
+		}
+	},
+	[RDr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2427252641424043),
+			.edge = {
+				UINT64_C(0x1A19181B16151417),
+				UINT64_C(0x0000000001000302)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4644454720222321),
+			.edge = {
+				UINT64_C(0x1013121109080B0A),
+				UINT64_C(0x0000000014171615)
+			}
+		}
+	},
+	[RBr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4241404324272625),
+			.edge = {
+				UINT64_C(0x151617141A19181B),
+				UINT64_C(0x0000000010131211)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4241404324272625),
+			.edge = {
+				UINT64_C(0x151617141A19181B),
+				UINT64_C(0x0000000010131211)
+			}
+		}
+	},
+	[LUr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2625272443404241),
+			.edge = {
+				UINT64_C(0x1B18191A14171615),
+				UINT64_C(0x0000000002030001)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4547464423212022),
+			.edge = {
+				UINT64_C(0x121110130A0B0809),
+				UINT64_C(0x0000000017141516)
+			}
+		}
+	},
+	[LFr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4340414225262724),
+			.edge = {
+				UINT64_C(0x14171615181B1A19),
+				UINT64_C(0x0000000011121310)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4142434027242526),
+			.edge = {
+				UINT64_C(0x16151417191A1B18),
+				UINT64_C(0x0000000012111013)
+			}
+		}
+	},
+	[LDr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2526242740434142),
+			.edge = {
+				UINT64_C(0x181B1A1917141516),
+				UINT64_C(0x0000000000010203)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4446474522202123),
+			.edge = {
+				UINT64_C(0x1310111208090A0B),
+				UINT64_C(0x0000000016151417)
+			}
+		}
+	},
+	[LBr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4043424126252427),
+			.edge = {
+				UINT64_C(0x171415161B18191A),
+				UINT64_C(0x0000000013101112)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4043424126252427),
+			.edge = {
+				UINT64_C(0x171415161B18191A),
+				UINT64_C(0x0000000013101112)
+			}
+		}
+	},
+	[FUr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2321222047454644),
+			.edge = {
+				UINT64_C(0x0A0B080911121310),
+				UINT64_C(0x0000000006070405)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2321222047454644),
+			.edge = {
+				UINT64_C(0x0A0B080911121310),
+				UINT64_C(0x0000000006070405)
+			}
+		}
+	},
+	[FRr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4745444621232220),
+			.edge = {
+				UINT64_C(0x111213100B0A0908),
+				UINT64_C(0x0000000015161714)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2724262542414340),
+			.edge = {
+				UINT64_C(0x191A1B1815161714),
+				UINT64_C(0x0000000003020100)
+			}
+		}
+	},
+	[FDr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2123202245474446),
+			.edge = {
+				UINT64_C(0x0B0A090812111013),
+				UINT64_C(0x0000000004050607)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2220232146444745),
+			.edge = {
+				UINT64_C(0x08090A0B10131211),
+				UINT64_C(0x0000000007060504)
+			}
+		}
+	},
+	[FLr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4547464423212022),
+			.edge = {
+				UINT64_C(0x121110130A0B0809),
+				UINT64_C(0x0000000017141516)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2625272443404241),
+			.edge = {
+				UINT64_C(0x1B18191A14171615),
+				UINT64_C(0x0000000002030001)
+			}
+		}
+	},
+	[BUr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2220232146444745),
+			.edge = {
+				UINT64_C(0x08090A0B10131211),
+				UINT64_C(0x0000000007060504)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2123202245474446),
+			.edge = {
+				UINT64_C(0x0B0A090812111013),
+				UINT64_C(0x0000000004050607)
+			}
+		}
+	},
+	[BRr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4446474522202123),
+			.edge = {
+				UINT64_C(0x1310111208090A0B),
+				UINT64_C(0x0000000016151417)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2526242740434142),
+			.edge = {
+				UINT64_C(0x181B1A1917141516),
+				UINT64_C(0x0000000000010203)
+			}
+		}
+	},
+	[BDr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2022212344464547),
+			.edge = {
+				UINT64_C(0x09080B0A13101112),
+				UINT64_C(0x0000000005040706)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2022212344464547),
+			.edge = {
+				UINT64_C(0x09080B0A13101112),
+				UINT64_C(0x0000000005040706)
+			}
+		}
+	},
+	[BLr] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4644454720222321),
+			.edge = {
+				UINT64_C(0x1013121109080B0A),
+				UINT64_C(0x0000000014171615)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2427252641424043),
+			.edge = {
+				UINT64_C(0x1A19181B16151417),
+				UINT64_C(0x0000000001000302)
+			}
+		}
+	},
+	[UFm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0302010007060504),
+			.edge = {
+				UINT64_C(0x0607040503020100),
+				UINT64_C(0x000000000A0B0809)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0302010007060504),
+			.edge = {
+				UINT64_C(0x0607040503020100),
+				UINT64_C(0x000000000A0B0809)
+			}
+		}
+	},
+	[ULm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0706040502030100),
+			.edge = {
+				UINT64_C(0x0302010007060504),
+				UINT64_C(0x00000000191A1B18)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0706040502030100),
+			.edge = {
+				UINT64_C(0x0302010007060504),
+				UINT64_C(0x00000000191A1B18)
+			}
+		}
+	},
+	[UBm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0203000106070405),
+			.edge = {
+				UINT64_C(0x0706050402030001),
+				UINT64_C(0x0000000008090A0B)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0203000106070405),
+			.edge = {
+				UINT64_C(0x0706050402030001),
+				UINT64_C(0x0000000008090A0B)
+			}
+		}
+	},
+	[URm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0607050403020001),
+			.edge = {
+				UINT64_C(0x0203000106070405),
+				UINT64_C(0x000000001B18191A)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0607050403020001),
+			.edge = {
+				UINT64_C(0x0203000106070405),
+				UINT64_C(0x000000001B18191A)
+			}
+		}
+	},
+	[DFm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0100030205040706),
+			.edge = {
+				UINT64_C(0x0405060700010203),
+				UINT64_C(0x000000000B0A0908)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0100030205040706),
+			.edge = {
+				UINT64_C(0x0405060700010203),
+				UINT64_C(0x000000000B0A0908)
+			}
+		}
+	},
+	[DLm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0405070601000203),
+			.edge = {
+				UINT64_C(0x0100030204050607),
+				UINT64_C(0x000000001A19181B)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0504060700010302),
+			.edge = {
+				UINT64_C(0x0001020305040706),
+				UINT64_C(0x00000000181B1A19)
+			}
+		}
+	},
+	[DBm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0001020304050607),
+			.edge = {
+				UINT64_C(0x0504070601000302),
+				UINT64_C(0x0000000009080B0A)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0001020304050607),
+			.edge = {
+				UINT64_C(0x0504070601000302),
+				UINT64_C(0x0000000009080B0A)
+			}
+		}
+	},
+	[DRm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x0504060700010302),
+			.edge = {
+				UINT64_C(0x0001020305040706),
+				UINT64_C(0x00000000181B1A19)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x0405070601000203),
+			.edge = {
+				UINT64_C(0x0100030204050607),
+				UINT64_C(0x000000001A19181B)
+			}
+		}
+	},
+	[RUm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2320222146454744),
+			.edge = {
+				UINT64_C(0x181B1A1914171615),
+				UINT64_C(0x0000000003020100)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2123222047454446),
+			.edge = {
+				UINT64_C(0x121110130B0A0908),
+				UINT64_C(0x0000000016151417)
+			}
+		}
+	},
+	[RFm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4546474423202122),
+			.edge = {
+				UINT64_C(0x17141516181B1A19),
+				UINT64_C(0x0000000012111013)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2526272443404142),
+			.edge = {
+				UINT64_C(0x17141516181B1A19),
+				UINT64_C(0x0000000012111013)
+			}
+		}
+	},
+	[RDm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2023212245464447),
+			.edge = {
+				UINT64_C(0x1B18191A17141516),
+				UINT64_C(0x0000000001000302)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2022232146444547),
+			.edge = {
+				UINT64_C(0x1310111209080B0A),
+				UINT64_C(0x0000000017141516)
+			}
+		}
+	},
+	[RBm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4645444720232221),
+			.edge = {
+				UINT64_C(0x141716151B18191A),
+				UINT64_C(0x0000000010131211)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2427262542414043),
+			.edge = {
+				UINT64_C(0x161514171A19181B),
+				UINT64_C(0x0000000013101112)
+			}
+		}
+	},
+	[LUm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2221232047444645),
+			.edge = {
+				UINT64_C(0x1A19181B15161714),
+				UINT64_C(0x0000000002030001)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2321202245474644),
+			.edge = {
+				UINT64_C(0x111213100A0B0809),
+				UINT64_C(0x0000000014171615)
+			}
+		}
+	},
+	[LFm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4744454621222320),
+			.edge = {
+				UINT64_C(0x15161714191A1B18),
+				UINT64_C(0x0000000011121310)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2724252641424340),
+			.edge = {
+				UINT64_C(0x15161714191A1B18),
+				UINT64_C(0x0000000011121310)
+			}
+		}
+	},
+	[LDm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2122202344474546),
+			.edge = {
+				UINT64_C(0x191A1B1816151417),
+				UINT64_C(0x0000000000010203)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2220212344464745),
+			.edge = {
+				UINT64_C(0x1013121108090A0B),
+				UINT64_C(0x0000000015161714)
+			}
+		}
+	},
+	[LBm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4447464522212023),
+			.edge = {
+				UINT64_C(0x161514171A19181B),
+				UINT64_C(0x0000000013101112)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x2625242740434241),
+			.edge = {
+				UINT64_C(0x141716151B18191A),
+				UINT64_C(0x0000000010131211)
+			}
+		}
+	},
+	[FUm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2725262443414240),
+			.edge = {
+				UINT64_C(0x0B0A090811121310),
+				UINT64_C(0x0000000007060504)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4745464423212220),
+			.edge = {
+				UINT64_C(0x0B0A090811121310),
+				UINT64_C(0x0000000007060504)
+			}
+		}
+	},
+	[FRm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4341404225272624),
+			.edge = {
+				UINT64_C(0x111213100A0B0809),
+				UINT64_C(0x0000000014171615)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4241434027242625),
+			.edge = {
+				UINT64_C(0x1A19181B15161714),
+				UINT64_C(0x0000000002030001)
+			}
+		}
+	},
+	[FDm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2527242641434042),
+			.edge = {
+				UINT64_C(0x0A0B080912111013),
+				UINT64_C(0x0000000005040706)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4644474522202321),
+			.edge = {
+				UINT64_C(0x09080B0A10131211),
+				UINT64_C(0x0000000006070405)
+			}
+		}
+	},
+	[FLm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4143424027252426),
+			.edge = {
+				UINT64_C(0x121110130B0A0908),
+				UINT64_C(0x0000000016151417)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4340424126252724),
+			.edge = {
+				UINT64_C(0x181B1A1914171615),
+				UINT64_C(0x0000000003020100)
+			}
+		}
+	},
+	[BUm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2624272542404341),
+			.edge = {
+				UINT64_C(0x09080B0A10131211),
+				UINT64_C(0x0000000006070405)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4547444621232022),
+			.edge = {
+				UINT64_C(0x0A0B080912111013),
+				UINT64_C(0x0000000005040706)
+			}
+		}
+	},
+	[BRm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4042434126242527),
+			.edge = {
+				UINT64_C(0x1310111209080B0A),
+				UINT64_C(0x0000000017141516)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4043414225262427),
+			.edge = {
+				UINT64_C(0x1B18191A17141516),
+				UINT64_C(0x0000000001000302)
+			}
+		}
+	},
+	[BDm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x2426252740424143),
+			.edge = {
+				UINT64_C(0x08090A0B13101112),
+				UINT64_C(0x0000000004050607)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4446454720222123),
+			.edge = {
+				UINT64_C(0x08090A0B13101112),
+				UINT64_C(0x0000000004050607)
+			}
+		}
+	},
+	[BLm] = {
+		[NORMAL] = {
+			.corner = UINT64_C(0x4240414324262725),
+			.edge = {
+				UINT64_C(0x1013121108090A0B),
+				UINT64_C(0x0000000015161714)
+			}
+		},
+		[INVERSE] = {
+			.corner = UINT64_C(0x4142404324272526),
+			.edge = {
+				UINT64_C(0x191A1B1816151417),
+				UINT64_C(0x0000000000010203)
+			}
+		}
+	},
+};
+
+#endif
@@ -1,11 +1,14 @@
 #include <stdio.h>
 #include <vector>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include "primitives.h"
 
-int main(void) {
+int main(int argc, char **argv) {
+    int nthreads = argc > 1 ? atoi(argv[1]) : 1;
+
     // Inizio del timer
     clock_t start_time = clock();
     
@@ -33,7 +36,7 @@ int main(void) {
     //     print_binary(trans.corner[i]);
     //     printf("\n");
     // }
-    twoPhase(cube);
+    twoPhase(cube, nthreads);
 
     // Fine del timer e calcolo del tempo trascorso
     clock_t end_time = clock();
@@ -2,6 +2,35 @@
 #include <stdbool.h>
 #include <string.h>
 
+#if defined(CUBE_DISPATCH)
+#if !defined(__GNUC__)
+#error "CUBE_DISPATCH requires GCC or Clang"
+#endif
+#define CUBE_BACKEND_PORTABLE
+#define CUBE_BACKEND_SWAR
+#if defined(__x86_64__) || defined(__i386__)
+#define CUBE_BACKEND_AVX2
+#define _target_avx2 __attribute__((target("avx2")))
+#endif
+#elif defined(CUBE_AVX2)
+#define CUBE_BACKEND_AVX2
+#elif defined(CUBE_SWAR)
+#define CUBE_BACKEND_SWAR
+#else
+#define CUBE_BACKEND_PORTABLE
+#endif
+
+#ifndef _target_avx2
+#define _target_avx2
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef CUBE_BACKEND_AVX2
+#include <immintrin.h>
+#endif
+
 #include "cube.h"
 
 #ifdef DEBUG
@@ -27,9 +56,15 @@
 
 #endif
 
+#ifdef CUBE_BACKEND_SWAR
+typedef struct {
+	uint64_t corner;
+	uint64_t edge[2];
+} cube_swar_t;
+#endif
+
 #include "constants.h"
 
-_static_inline cube_t invertco(cube_t);
 _static int permsign(uint8_t *, int);
 _static uint8_t readco(const char *);
 _static uint8_t readcp(const char *);
@@ -39,8 +74,18 @@ _static cube_t read_H48(const char *);
 _static uint8_t readpiece_LST(const char **);
 _static cube_t read_LST(const char *);
 _static int writepiece_LST(uint8_t, char *);
-_static void write_H48(cube_t, char *);
-_static void write_LST(cube_t, char *);
+_static size_t write_H48(cube_t, char *);
+_static size_t write_LST(cube_t, char *);
+_static cube_codec_error_t readline_H48(const char *, const char *, cube_t *);
+_static cube_codec_error_t readline_LST(const char *, const char *, cube_t *);
+_static void writeuint(uint8_t *, uint64_t, int);
+_static uint64_t readuint(const uint8_t *, int);
+_static void writecube_stream(cube_t, uint8_t *);
+_static cube_t readcube_stream(const uint8_t *);
+_static int stream_output(cube_stream_writer_t *, const void *, size_t);
+_static int stream_flush(cube_stream_writer_t *);
+_static int stream_block(cube_stream_reader_t *, size_t);
+_static int stream_skip(cube_stream_reader_t *);
 _static uint8_t readmove(char);
 _static uint8_t readmodifier(char);
 
@@ -188,7 +233,7 @@ writepiece_LST(uint8_t piece, char *buf)
 	return len+2;
 }
 
-_static void
+_static size_t
 write_H48(cube_t cube, char *buf)
 {
 	uint8_t piece, perm, orient;
@@ -215,9 +260,11 @@ write_H48(cube_t cube, char *buf)
 	}
 
 	buf[48+39] = '\0';
+
+	return 48+39;
 }
 
-_static void
+_static size_t
 write_LST(cube_t cube, char *buf)
 {
 	int i, ptr;
@@ -236,6 +283,232 @@ write_LST(cube_t cube, char *buf)
 	}
 
 	*(buf+ptr-2) = 0;
+
+	return ptr-2;
+}
+
+/*
+ * The readline functions read a single cube from the characters from b to
+ * end, as the bulk reader does for each line. Unlike read_H48 and read_LST
+ * they reject anything after the cube and check that the cube is
+ * consistent.
+ */
+
+_static cube_codec_error_t
+readline_H48(const char *b, const char *end, cube_t *cube)
+{
+	int i;
+	uint8_t piece, orient;
+	cube_t c;
+
+	for (i = 0; i < 12; i++) {
+		while (b < end && (*b == ' ' || *b == '\t'))
+			b++;
+		if (end - b < 3)
+			return CUBE_CODEC_SYNTAX;
+		piece = edgecode[facecode[(uint8_t)b[0]]][facecode[(uint8_t)b[1]]];
+		orient = (uint8_t)(b[2] - '0');
+		if (piece == 0 || orient > 1)
+			return CUBE_CODEC_SYNTAX;
+		c.edge[i] = (piece - 1) | (orient << _eoshift);
+		b += 3;
+	}
+	for (i = 0; i < 8; i++) {
+		while (b < end && (*b == ' ' || *b == '\t'))
+			b++;
+		if (end - b < 4)
+			return CUBE_CODEC_SYNTAX;
+		piece = cornercode[facecode[(uint8_t)b[0]]]
+		    [facecode[(uint8_t)b[1]]][facecode[(uint8_t)b[2]]];
+		orient = (uint8_t)(b[3] - '0');
+		if (piece == 0 || orient > 2)
+			return CUBE_CODEC_SYNTAX;
+		c.corner[i] = (piece - 1) | (orient << _coshift);
+		b += 4;
+	}
+
+	while (b < end && (*b == ' ' || *b == '\t' || *b == '\r'))
+		b++;
+	if (b != end)
+		return CUBE_CODEC_SYNTAX;
+
+	*cube = c;
+	return cube_consistent(c) ? CUBE_CODEC_OK : CUBE_CODEC_INCONSISTENT;
+}
+
+_static cube_codec_error_t
+readline_LST(const char *b, const char *end, cube_t *cube)
+{
+	int i, x, digits;
+	uint8_t piece[20];
+
+	for (i = 0; i < 20; i++) {
+		while (b < end && (*b == ',' || *b == ' ' || *b == '\t'))
+			b++;
+		for (x = 0, digits = 0; b < end && (unsigned)(*b - '0') < 10;
+		    b++, digits++)
+			x = x * 10 + (*b - '0');
+		if (digits == 0 || digits > 3 || x > 255)
+			return CUBE_CODEC_SYNTAX;
+		piece[i] = x;
+	}
+
+	while (b < end && (*b == ',' || *b == ' ' || *b == '\t' || *b == '\r'))
+		b++;
+	if (b != end)
+		return CUBE_CODEC_SYNTAX;
+
+	memcpy(cube->corner, piece, 8);
+	memcpy(cube->edge, piece + 8, 12);
+	return cube_consistent(*cube) ? CUBE_CODEC_OK : CUBE_CODEC_INCONSISTENT;
+}
+
+/*
+ * Binary streams. A stream starts with a 16-byte header: the magic string
+ * "CUBESTRM", the version, the flags, two zero bytes and the number of cubes
+ * per block. Then come the blocks, each made of an 8-byte header (the number
+ * of cubes and the number of bytes that follow) and the cubes. Every block
+ * is full except the last one, and a block with no cubes ends the stream.
+ * All integers are little-endian.
+ *
+ * A cube takes 13 bytes: the 12 edges and then the 8 corners, 5 bits each
+ * (the piece, and the orientation above it), packed from the lowest bit.
+ * With CUBE_STREAM_MOVES each cube is followed by the number of moves and
+ * the moves, one byte each.
+ *
+ * Since the blocks before the last are full, the reader finds the block of
+ * any cube by skipping whole blocks using their headers. Without moves all
+ * records have the same size, and the block is found directly.
+ */
+
+_static void
+writeuint(uint8_t *b, uint64_t x, int bytes)
+{
+	int i;
+
+	for (i = 0; i < bytes; i++)
+		b[i] = (x >> (8*i)) & 0xFF;
+}
+
+_static uint64_t
+readuint(const uint8_t *b, int bytes)
+{
+	int i;
+	uint64_t x;
+
+	for (i = 0, x = 0; i < bytes; i++)
+		x |= (uint64_t)b[i] << (8*i);
+
+	return x;
+}
+
+_static void
+writecube_stream(cube_t cube, uint8_t *b)
+{
+	int i;
+	uint64_t e, c;
+
+	for (i = 0, e = 0; i < 12; i++)
+		e |= (uint64_t)(cube.edge[i] & (_pbits | _eobit)) << (5*i);
+	for (i = 0, c = 0; i < 8; i++)
+		c |= (uint64_t)((cube.corner[i] & _pbits) |
+		    ((cube.corner[i] & _cobits2) >> 2)) << (5*i);
+
+	writeuint(b, e | (c << 60), 8);
+	writeuint(b + 8, c >> 4, 5);
+}
+
+_static cube_t
+readcube_stream(const uint8_t *b)
+{
+	int i;
+	uint64_t e, c, x;
+	cube_t cube;
+
+	e = readuint(b, 8);
+	c = (e >> 60) | (readuint(b + 8, 5) << 4);
+	for (i = 0; i < 12; i++) {
+		x = (e >> (5*i)) & 0x1F;
+		cube.edge[i] = x;
+	}
+	for (i = 0; i < 8; i++) {
+		x = (c >> (5*i)) & 0x1F;
+		cube.corner[i] = (x & 7) | ((x & 0x18) << 2);
+	}
+
+	return cube;
+}
+
+_static int
+stream_output(cube_stream_writer_t *w, const void *data, size_t len)
+{
+	if (!w->error && w->write(data, len, w->arg) != len) {
+		DBG_LOG("cube stream: write error\n");
+		w->error = true;
+	}
+
+	return w->error ? -1 : 0;
+}
+
+_static int
+stream_flush(cube_stream_writer_t *w)
+{
+	int ret;
+
+	writeuint(w->buf, w->n, 4);
+	writeuint(w->buf + 4, w->len - _stream_blockheader, 4);
+	ret = stream_output(w, w->buf, w->len);
+	w->len = _stream_blockheader;
+	w->n = 0;
+
+	return ret;
+}
+
+/* Enters the block at offset off, checking that it fits in the stream */
+_static int
+stream_block(cube_stream_reader_t *r, size_t off)
+{
+	uint64_t n, bytes;
+
+	if (off > r->len || r->len - off < _stream_blockheader)
+		goto stream_block_error;
+	n = readuint(r->buf + off, 4);
+	bytes = readuint(r->buf + off + 4, 4);
+	if (n > r->blocksize || bytes > r->len - off - _stream_blockheader)
+		goto stream_block_error;
+	if (!(r->flags & CUBE_STREAM_MOVES) && bytes != n * _stream_cube)
+		goto stream_block_error;
+
+	r->pos = off + _stream_blockheader;
+	r->blockend = r->pos + bytes;
+	r->left = n;
+	r->end = n == 0;
+	return 0;
+
+stream_block_error:
+	DBG_LOG("cube stream: invalid block at offset %zu\n", off);
+	return -1;
+}
+
+/* Moves past the next cube without decoding it */
+_static int
+stream_skip(cube_stream_reader_t *r)
+{
+	size_t size;
+
+	size = _stream_cube;
+	if (r->flags & CUBE_STREAM_MOVES) {
+		if (r->blockend - r->pos < _stream_cube + 1)
+			return -1;
+		size += 1 + r->buf[r->pos + _stream_cube];
+	}
+	if (r->blockend - r->pos < size)
+		return -1;
+
+	r->pos += size;
+	r->left--;
+	r->index++;
+	return 0;
 }
 
 _static uint8_t
@@ -270,232 +543,900 @@ readmodifier(char c)
 	case '\'':
 		return 2;
 	default:
-		return 0;
+		return _error;
 	}
 }
 
-_static_inline cube_t
-invertco(cube_t c)
+/*
+ * Each backend provides the same set of functions, suffixed with its name,
+ * on its own representation of the cube. The public functions do not call
+ * them directly, but through a table of wrappers that work on cube_t. With
+ * CUBETYPE=CUBE_DISPATCH all the backends are compiled in and the table is
+ * chosen when the program starts, otherwise there is only one of them.
+ */
+
+typedef struct {
+	const char *name;
+	bool (*solved)(cube_t);
+	cube_t (*compose)(cube_t, cube_t);
+	cube_t (*inverse)(cube_t);
+	cube_t (*move)(cube_t, move_t);
+	cube_t (*transform)(cube_t, trans_t);
+	cube_t (*canonical)(cube_t, bool, trans_t *, bool *);
+	void (*compose_batch)(const cube_t *, const cube_t *, size_t, cube_t *);
+	void (*move_batch)(const cube_t *, move_t, size_t, cube_t *);
+	void (*transform_batch)(const cube_t *, trans_t, size_t, cube_t *);
+	void (*soa_move)(const cube_soa_t *, move_t, cube_soa_t *);
+	void (*soa_transform)(const cube_soa_t *, trans_t, cube_soa_t *);
+} backend_t;
+
+/*
+ * The batch functions load the move or transformation once and keep it in
+ * the backend's representation for the whole loop. The structure-of-arrays
+ * functions are compiled once for each backend, so that the loops are
+ * vectorized with the widest instructions available. Each backend provides
+ * its own soa_transform_X, because compilers turn table lookups into slow
+ * gather instructions.
+ *
+ * The canonical cube is found without leaving the backend's representation:
+ * transformmin_X(c, t, &best) replaces best with the transformation of c
+ * when it is smaller, and returns true if it did. UFr is the identity, so
+ * the cube itself is the first candidate.
+ */
+#define _backend(b, T, attr) \
+_static attr bool \
+cube_solved_##b(cube_t c) \
+{ \
+	return issolved_##b(load_##b(c)); \
+} \
+_static attr cube_t \
+cube_compose_##b(cube_t c1, cube_t c2) \
+{ \
+	return store_##b(compose_##b(load_##b(c1), load_##b(c2))); \
+} \
+_static attr cube_t \
+cube_inverse_##b(cube_t c) \
+{ \
+	return store_##b(inverse_##b(load_##b(c))); \
+} \
+_static attr cube_t \
+cube_move_##b(cube_t c, move_t m) \
+{ \
+	return store_##b(move_##b(load_##b(c), m)); \
+} \
+_static attr cube_t \
+cube_transform_##b(cube_t c, trans_t t) \
+{ \
+	return store_##b(transform_##b(load_##b(c), t)); \
+} \
+_static attr cube_t \
+cube_canonical_##b(cube_t c, bool inverse, trans_t *t, bool *inverted) \
+{ \
+	int i, k; \
+	T x, best; \
+	trans_t bt; \
+	bool binv; \
+	x = load_##b(c); \
+	best = x; \
+	bt = UFr; \
+	binv = false; \
+	for (k = 0; k < (inverse ? 2 : 1); k++) { \
+		if (k == 1) \
+			x = inverse_##b(x); \
+		for (i = k == 0 ? 1 : 0; i < 48; i++) { \
+			if (transformmin_##b(x, (trans_t)i, &best)) { \
+				bt = (trans_t)i; \
+				binv = k == 1; \
+			} \
+		} \
+	} \
+	if (t != NULL) \
+		*t = bt; \
+	if (inverted != NULL) \
+		*inverted = binv; \
+	return store_##b(best); \
+} \
+_static attr void \
+cube_compose_batch_##b(const cube_t *c1, const cube_t *c2, size_t n, \
+    cube_t *out) \
+{ \
+	size_t i; \
+	for (i = 0; i < n; i++) \
+		out[i] = store_##b(compose_##b(load_##b(c1[i]), \
+		    load_##b(c2[i]))); \
+} \
+_static attr void \
+cube_move_batch_##b(const cube_t *c, move_t m, size_t n, cube_t *out) \
+{ \
+	size_t i; \
+	T mcube; \
+	mcube = movecube_##b(m); \
+	for (i = 0; i < n; i++) \
+		out[i] = store_##b(compose_##b(load_##b(c[i]), mcube)); \
+} \
+_static attr void \
+cube_transform_batch_##b(const cube_t *c, trans_t t, size_t n, \
+    cube_t *out) \
+{ \
+	size_t i; \
+	T tcube, tinv, ret; \
+	tcube = transcube_##b(t, NORMAL); \
+	tinv = transcube_##b(t, INVERSE); \
+	for (i = 0; i < n; i++) { \
+		ret = compose_##b(compose_##b(tcube, load_##b(c[i])), tinv); \
+		out[i] = store_##b(t < 24 ? ret : invertco_##b(ret)); \
+	} \
+} \
+_static attr void \
+cube_soa_move_##b(const cube_soa_t *c, move_t m, cube_soa_t *out) \
+{ \
+	soa_move(c, m, out); \
+} \
+_static attr void \
+cube_soa_transform_##b(const cube_soa_t *c, trans_t t, cube_soa_t *out) \
+{ \
+	soa_transform_##b(c, t, out); \
+} \
+_static const backend_t backend_##b = { \
+	.name = #b, \
+	.solved = cube_solved_##b, \
+	.compose = cube_compose_##b, \
+	.inverse = cube_inverse_##b, \
+	.move = cube_move_##b, \
+	.transform = cube_transform_##b, \
+	.canonical = cube_canonical_##b, \
+	.compose_batch = cube_compose_batch_##b, \
+	.move_batch = cube_move_batch_##b, \
+	.transform_batch = cube_transform_batch_##b, \
+	.soa_move = cube_soa_move_##b, \
+	.soa_transform = cube_soa_transform_##b, \
+};
+
+_static_inline uint8_t
+composeedge(uint8_t piece1, uint8_t piece2)
 {
-	uint8_t i, piece, orien;
-	cube_t ret;
-
-	ret = c;
-	for (i = 0; i < 8; i++) {
-		piece = c.corner[i];
-		orien = ((piece << 1) | (piece >> 1)) & _cobits2;
-		ret.corner[i] = (piece & _pbits) | orien;
-	}
-
-	return ret;
+	return (piece1 & _pbits) | ((piece1 ^ piece2) & _eobit);
 }
 
-_static int
-permsign(uint8_t *a, int n)
+_static_inline uint8_t
+composecorner(uint8_t piece1, uint8_t piece2)
 {
-	int i, j;
-	uint8_t ret = 0;
+	uint8_t aux, auy;
 
-	for (i = 0; i < n; i++)
-		for (j = i+1; j < n; j++)
-			ret += a[i] > a[j] ? 1 : 0;
+	aux = (piece2 & _cobits) + (piece1 & _cobits);
+	auy = (aux + _ctwist_cw) >> 2U;
 
-	return ret % 2;
+	return (piece1 & _pbits) | ((aux + auy) & _cobits2);
 }
 
-cube_t
-cube_new(void)
+_static_inline void
+soa_move(const cube_soa_t *c, move_t m, cube_soa_t *out)
 {
-	return solved;
+	size_t i, k, n;
+	uint8_t piece, *dst;
+	const uint8_t *src;
+
+	/*
+	 * For a fixed move, each position takes its piece from a fixed
+	 * position of the cube, and the orientation is changed by a fixed
+	 * amount. Each of the 20 loops below is a plain byte loop.
+	 */
+	n = c->n;
+	for (i = 0; i < 12; i++) {
+		piece = move_table[m].edge[i];
+		src = c->edge[piece & _pbits];
+		dst = out->edge[i];
+		for (k = 0; k < n; k++)
+			dst[k] = composeedge(src[k], piece);
+	}
+	for (i = 0; i < 8; i++) {
+		piece = move_table[m].corner[i];
+		src = c->corner[piece & _pbits];
+		dst = out->corner[i];
+		for (k = 0; k < n; k++)
+			dst[k] = composecorner(src[k], piece);
+	}
 }
 
-cube_t
-cube_clone(cube_t c)
+/*
+ * Position i of the transformed cube depends only on the piece in position
+ * tinv[i] of the original cube, through a function of the piece that we
+ * tabulate for each position before running over the cubes. The result is
+ * the source position and a 128-entry table indexed by piece.
+ */
+_static_inline uint8_t
+soa_edgelut(trans_t t, uint8_t i, uint8_t lut[static 128])
 {
-	cube_t ret;
+	uint8_t p, v, ptinv;
+	cube_t tcube;
 
-	memcpy(&ret, &c, sizeof(cube_t));
+	tcube = trans_table[t][NORMAL];
+	ptinv = trans_table[t][INVERSE].edge[i];
+	for (p = 0; p < 12; p++)
+		for (v = p; v <= (p | _eobit); v += _eobit)
+			lut[v] = composeedge(composeedge(tcube.edge[p], v), ptinv);
 
-	return ret;
+	return ptinv & _pbits;
 }
 
-bool
-cube_consistent(cube_t cube)
+_static_inline uint8_t
+soa_cornerlut(trans_t t, uint8_t i, uint8_t lut[static 128])
 {
-	uint8_t i, p, e, piece;
-	bool found[12];
-
-	for (i = 0; i < 12; i++)
-		found[i] = false;
-	for (i = 0; i < 12; i++) {
-		piece = cube.edge[i];
-		p = piece & _pbits;
-		e = piece & _eobit;
-		if (p >= 12)
-			goto inconsistent_ep;
-		if (e != 0 && e != _eobit)
-			goto inconsistent_eo;
-		found[p] = true;
-	}
-	for (i = 0; i < 12; i++)
-		if (!found[i])
-			goto inconsistent_ep;
+	uint8_t p, v, ptinv, piece;
+	cube_t tcube;
 
-	for (i = 0; i < 8; i++)
-		found[i] = false;
-	for (i = 0; i < 8; i++) {
-		piece = cube.corner[i];
-		p = piece & _pbits;
-		e = piece & _cobits;
-		if (p >= 8)
-			goto inconsistent_cp;
-		if (e != 0 && e != _ctwist_cw && e != _ctwist_ccw)
-			goto inconsistent_co;
-		found[p] = true;
+	tcube = trans_table[t][NORMAL];
+	ptinv = trans_table[t][INVERSE].corner[i];
+	for (p = 0; p < 8; p++) {
+		for (v = p; v <= (p | _ctwist_ccw); v += _ctwist_cw) {
+			piece = composecorner(tcube.corner[p], v);
+			piece = composecorner(piece, ptinv);
+			if (t >= 24)
+				piece = (piece & _pbits) |
+				    (((piece << 1) | (piece >> 1)) & _cobits2);
+			lut[v] = piece;
+		}
 	}
-	for (i = 0; i < 8; i++)
-		if (!found[i])
-			goto inconsistent_co;
 
-	return true;
-
-inconsistent_ep:
-	DBG_LOG("Inconsistent EP\n");
-	return false;
-inconsistent_cp:
-	DBG_LOG("Inconsistent CP\n");
-	return false;
-inconsistent_eo:
-	DBG_LOG("Inconsistent EO\n");
-	return false;
-inconsistent_co:
-	DBG_LOG("Inconsistent CO\n");
-	return false;
+	return ptinv & _pbits;
 }
 
-bool
-cube_solvable(cube_t cube)
+_static_inline void
+soa_lookup(const uint8_t *src, const uint8_t lut[static 128], size_t n,
+    uint8_t *dst)
 {
-	uint8_t i, eo, co, piece, edges[12], corners[8];
-
-	DBG_ASSERT(cube_consistent(cube), false,
-	    "cube_solvable: cube is inconsistent\n");
+	size_t k;
 
-	for (i = 0; i < 12; i++)
-		edges[i] = cube.edge[i] & _pbits;
-	for (i = 0; i < 8; i++)
-		corners[i] = cube.corner[i] & _pbits;
+	for (k = 0; k < n; k++)
+		dst[k] = lut[src[k] & 0x7F];
+}
 
-	if (permsign(edges, 12) != permsign(corners, 8))
-		goto solvable_parity;
+_static_inline void
+soa_transform(const cube_soa_t *c, trans_t t, cube_soa_t *out)
+{
+	uint8_t i, q, lut[128] = {0};
 
-	eo = 0;
 	for (i = 0; i < 12; i++) {
-		piece = cube.edge[i];
-		eo += (piece & _eobit) >> _eoshift;
+		q = soa_edgelut(t, i, lut);
+		soa_lookup(c->edge[q], lut, c->n, out->edge[i]);
 	}
-	if (eo % 2 != 0)
-		goto solvable_eo;
-
-	co = 0;
 	for (i = 0; i < 8; i++) {
-		piece = cube.corner[i];
-		co += (piece & _cobits) >> _coshift;
+		q = soa_cornerlut(t, i, lut);
+		soa_lookup(c->corner[q], lut, c->n, out->corner[i]);
 	}
-	if (co % 3 != 0)
-		goto solvable_co;
-
-	return true;
-
-solvable_parity:
-	DBG_LOG("EP and CP parities are different\n");
-	return false;
-solvable_eo:
-	DBG_LOG("Odd number of flipped edges\n");
-	return false;
-solvable_co:
-	DBG_LOG("Sum of corner orientation is not multiple of 3\n");
-	return false;
 }
 
-bool
-cube_solved(cube_t cube)
+#ifdef CUBE_BACKEND_AVX2
+
+/*
+ * AVX2 backend. The cube lives in a single 256-bit register: the corners
+ * occupy bytes 0-7 of the low lane and the edges bytes 0-11 of the high
+ * lane, all other bytes are zero. Since the index of a piece is never
+ * larger than the size of its lane, composing two permutations is a single
+ * _mm256_shuffle_epi8.
+ */
+
+#define _co_avx2 _mm256_set_epi64x(0, 0, 0, INT64_C(0x6060606060606060))
+#define _cocw_avx2 _mm256_set_epi64x(0, 0, 0, INT64_C(0x2020202020202020))
+#define _eo_avx2 _mm256_set_epi64x(INT64_C(0x10101010), \
+    INT64_C(0x1010101010101010), 0, 0)
+#define _p_avx2 _mm256_set_epi64x(INT64_C(0x0F0F0F0F), \
+    INT64_C(0x0F0F0F0F0F0F0F0F), 0, INT64_C(0x0F0F0F0F0F0F0F0F))
+
+_static_inline _target_avx2 __m256i
+load_avx2(cube_t c)
 {
-	return cube_equal(cube, solved);
+	int64_t co, e1, e2;
+	int32_t e3;
+
+	/* Going through a byte buffer makes the 256-bit load stall on
+	 * store forwarding, assembling the register from words does not */
+	memcpy(&co, c.corner, 8);
+	memcpy(&e1, c.edge, 8);
+	memcpy(&e3, c.edge + 8, 4);
+	e2 = (int64_t)(uint32_t)e3;
+
+	return _mm256_set_epi64x(e2, e1, 0, co);
 }
 
-bool
-cube_equal(cube_t c1, cube_t c2)
+_static_inline _target_avx2 cube_t
+store_avx2(__m256i c)
 {
-	int i;
-	bool ret;
+	int64_t co, e1;
+	int32_t e2;
+	cube_t ret;
 
-	ret = true;
-	for (i = 0; i < 8; i++)
-		ret = ret && c1.corner[i] == c2.corner[i];
-	for (i = 0; i < 12; i++)
-		ret = ret && c1.edge[i] == c2.edge[i];
+	co = _mm256_extract_epi64(c, 0);
+	e1 = _mm256_extract_epi64(c, 2);
+	e2 = _mm256_extract_epi32(c, 6);
+	memcpy(ret.corner, &co, 8);
+	memcpy(ret.edge, &e1, 8);
+	memcpy(ret.edge + 8, &e2, 4);
 
 	return ret;
 }
 
-bool
-cube_error(cube_t cube)
+_static_inline _target_avx2 bool
+equal_avx2(__m256i c1, __m256i c2)
 {
-	return cube_equal(cube, zero);
+	return _mm256_movemask_epi8(_mm256_cmpeq_epi8(c1, c2)) == -1;
 }
 
-cube_t
-cube_compose(cube_t c1, cube_t c2)
+/*
+ * Compares the cubes as cube_t in memcmp() order. The corners come before
+ * the edges here too, so the lowest byte that differs decides; the padding
+ * bytes are always zero.
+ */
+_static_inline _target_avx2 bool
+less_avx2(__m256i c1, __m256i c2)
 {
-	cube_t ret;
-	uint8_t i, piece1, piece2, p, orien, aux, auy;
+	uint32_t neq, le;
 
-	DBG_ASSERT(cube_consistent(c1) && cube_consistent(c2),
-	    zero, "cube_compose error: inconsistent cube\n")
+	neq = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(c1, c2));
+	le = (uint32_t)_mm256_movemask_epi8(
+	    _mm256_cmpeq_epi8(_mm256_min_epu8(c1, c2), c1));
 
-	ret = zero;
+	return (le & neq & -neq) != 0;
+}
 
-	for (i = 0; i < 12; i++) {
-		piece2 = c2.edge[i];
-		p = piece2 & _pbits;
-		piece1 = c1.edge[p];
-		orien = (piece2 ^ piece1) & _eobit;
-		ret.edge[i] = (piece1 & _pbits) | orien;
-	}
+_static_inline _target_avx2 bool
+issolved_avx2(__m256i c)
+{
+	return equal_avx2(c, _mm256_loadu_si256((__m256i *)solved_avx2));
+}
 
-	for (i = 0; i < 8; i++) {
-		piece2 = c2.corner[i];
-		p = piece2 & _pbits;
-		piece1 = c1.corner[p];
-		aux = (piece2 & _cobits) + (piece1 & _cobits);
-		auy = (aux + _ctwist_cw) >> 2U;
-		orien = (aux + auy) & _cobits2;
-		ret.corner[i] = (piece1 & _pbits) | orien;
-	}
+_static_inline _target_avx2 __m256i
+invertco_avx2(__m256i c)
+{
+	__m256i co, shleft, shright, swapped;
 
-	return ret;
+	/* The orientation bits never cross a byte boundary, so 16-bit
+	 * shifts are fine here */
+	co = _mm256_and_si256(c, _co_avx2);
+	shleft = _mm256_slli_epi16(co, 1);
+	shright = _mm256_srli_epi16(co, 1);
+	swapped = _mm256_and_si256(_mm256_or_si256(shleft, shright), _co_avx2);
+
+	return _mm256_or_si256(_mm256_andnot_si256(_co_avx2, c), swapped);
 }
 
-cube_t
-cube_inverse(cube_t cube)
+_static_inline _target_avx2 __m256i
+compose_avx2(__m256i c1, __m256i c2)
 {
-	cube_t ret;
-	uint8_t i, piece, orien;
+	__m256i p2, s, eo, co1, co2, aux, auy, co;
 
-	DBG_ASSERT(cube_consistent(cube), zero,
-	    "cube_inverse error: inconsistent cube\n");
+	p2 = _mm256_and_si256(c2, _p_avx2);
+	s = _mm256_shuffle_epi8(c1, p2);
 
-	ret = zero;
+	eo = _mm256_and_si256(_mm256_xor_si256(s, c2), _eo_avx2);
 
-	for (i = 0; i < 12; i++) {
-		piece = cube.edge[i];
-		orien = piece & _eobit;
+	/* Same as in the portable version; the low bits of aux are zero,
+	 * so the 16-bit shift does not leak between bytes */
+	co1 = _mm256_and_si256(s, _co_avx2);
+	co2 = _mm256_and_si256(c2, _co_avx2);
+	aux = _mm256_add_epi8(co1, co2);
+	auy = _mm256_srli_epi16(_mm256_add_epi8(aux, _cocw_avx2), 2);
+	co = _mm256_and_si256(_mm256_add_epi8(aux, auy), _co_avx2);
+
+	return _mm256_or_si256(_mm256_and_si256(s, _p_avx2),
+	    _mm256_or_si256(eo, co));
+}
+
+_static_inline _target_avx2 __m256i
+inverse_avx2(__m256i c)
+{
+	/*
+	 * The order of a permutation of at most 12 elements divides
+	 * lcm(1, ..., 12) = 27720, so its inverse is its 27719-th power.
+	 * 27719 = 0b110110001000111, computed by square and multiply.
+	 * The padding bytes do not affect the pieces and are masked out
+	 * at the end.
+	 */
+	int i;
+	__m256i p, vi, ori;
+
+	p = _mm256_and_si256(c, _p_avx2);
+	vi = p;
+	for (i = 13; i >= 0; i--) {
+		vi = _mm256_shuffle_epi8(vi, vi);
+		if ((27719 >> i) & 1)
+			vi = _mm256_shuffle_epi8(vi, p);
+	}
+	vi = _mm256_and_si256(vi, _p_avx2);
+
+	ori = _mm256_shuffle_epi8(c, vi);
+	ori = _mm256_and_si256(ori, _mm256_or_si256(_eo_avx2, _co_avx2));
+
+	return invertco_avx2(_mm256_or_si256(vi, ori));
+}
+
+_static_inline _target_avx2 __m256i
+movecube_avx2(move_t m)
+{
+	return _mm256_loadu_si256((__m256i *)move_table_avx2[m]);
+}
+
+_static_inline _target_avx2 __m256i
+transcube_avx2(trans_t t, int inverse)
+{
+	return _mm256_loadu_si256((__m256i *)trans_table_avx2[t][inverse]);
+}
+
+_static_inline _target_avx2 __m256i
+move_avx2(__m256i c, move_t m)
+{
+	return compose_avx2(c, movecube_avx2(m));
+}
+
+_static_inline _target_avx2 __m256i
+transform_avx2(__m256i c, trans_t t)
+{
+	__m256i ret;
+
+	ret = compose_avx2(compose_avx2(transcube_avx2(t, NORMAL), c),
+	    transcube_avx2(t, INVERSE));
+
+	return t < 24 ? ret : invertco_avx2(ret);
+}
+
+/* See _backend; the whole cube is compared at once */
+_static_inline _target_avx2 bool
+transformmin_avx2(__m256i c, trans_t t, __m256i *best)
+{
+	__m256i ret;
+
+	ret = transform_avx2(c, t);
+	if (!less_avx2(ret, *best))
+		return false;
+
+	*best = ret;
+	return true;
+}
+
+/*
+ * Table lookups with 32 bytes at a time: an edge has 2 possible
+ * orientations and a corner has 3, so we use one shuffle for each of them
+ * and blend the results.
+ */
+_static_inline _target_avx2 void
+soa_lookup_avx2(const uint8_t *src, const uint8_t lut[static 128], size_t n,
+    uint8_t *dst, uint8_t omax, uint8_t ostep)
+{
+	size_t k;
+	uint8_t o;
+	__m256i x, p, r, l, m;
+
+	for (k = 0; k + 32 <= n; k += 32) {
+		x = _mm256_loadu_si256((__m256i *)(src + k));
+		p = _mm256_and_si256(x, _mm256_set1_epi8(_pbits));
+		x = _mm256_and_si256(x, _mm256_set1_epi8(_eobit | _cobits2));
+		r = _mm256_setzero_si256();
+		for (o = 0; o <= omax; o += ostep) {
+			l = _mm256_broadcastsi128_si256(
+			    _mm_loadu_si128((__m128i *)(lut + o)));
+			m = _mm256_cmpeq_epi8(x, _mm256_set1_epi8(o));
+			r = _mm256_blendv_epi8(r, _mm256_shuffle_epi8(l, p), m);
+		}
+		_mm256_storeu_si256((__m256i *)(dst + k), r);
+	}
+	soa_lookup(src + k, lut, n - k, dst + k);
+}
+
+_static_inline _target_avx2 void
+soa_transform_avx2(const cube_soa_t *c, trans_t t, cube_soa_t *out)
+{
+	uint8_t i, q, lut[128] = {0};
+
+	for (i = 0; i < 12; i++) {
+		q = soa_edgelut(t, i, lut);
+		soa_lookup_avx2(c->edge[q], lut, c->n, out->edge[i],
+		    _eobit, _eobit);
+	}
+	for (i = 0; i < 8; i++) {
+		q = soa_cornerlut(t, i, lut);
+		soa_lookup_avx2(c->corner[q], lut, c->n, out->corner[i],
+		    _ctwist_ccw, _ctwist_cw);
+	}
+}
+
+_backend(avx2, __m256i, _target_avx2)
+
+#endif
+
+#ifdef CUBE_BACKEND_SWAR
+
+/*
+ * Portable SWAR backend, for machines where no SIMD extension can be used.
+ * The pieces are stored as in cube_t, one byte each, but packed in 64-bit
+ * words: the corners in one word and the edges in two (the last one holds
+ * only four edges). The orientation arithmetic, the comparisons and the
+ * conversions from and to cube_t are done on whole words. The permutation
+ * is gathered from a byte copy of the first cube, indexed by the pieces of
+ * the second one; the result is assembled in registers, which avoids the
+ * store forwarding stalls of the byte-by-byte portable version.
+ */
+
+#define _co_swar       UINT64_C(0x6060606060606060)
+#define _cocw_swar     UINT64_C(0x2020202020202020)
+#define _coshr_swar    UINT64_C(0x3F3F3F3F3F3F3F3F)
+#define _p_swar        UINT64_C(0x0F0F0F0F0F0F0F0F)
+#define _eo_swar       UINT64_C(0x1010101010101010)
+
+_static_inline uint64_t
+bytestoword_swar(const uint8_t *b, size_t n)
+{
+	uint64_t ret;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	ret = 0;
+	memcpy(&ret, b, n);
+#else
+	size_t i;
+
+	for (i = 0, ret = 0; i < n; i++)
+		ret |= (uint64_t)b[i] << (8*i);
+#endif
+
+	return ret;
+}
+
+_static_inline void
+wordtobytes_swar(uint64_t w, uint8_t *b, size_t n)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	memcpy(b, &w, n);
+#else
+	size_t i;
+
+	for (i = 0; i < n; i++)
+		b[i] = (w >> (8*i)) & 0xFF;
+#endif
+}
+
+_static_inline uint64_t
+gather_swar(const uint8_t *b, uint64_t w, int n)
+{
+	int i;
+	uint64_t ret;
+
+	for (i = 0, ret = 0; i < n; i++)
+		ret |= (uint64_t)b[(w >> (8*i)) & _pbits] << (8*i);
+
+	return ret;
+}
+
+_static_inline uint64_t
+collect_swar(const uint8_t *b, int n)
+{
+	int i;
+	uint64_t ret;
+
+	/* Reading back the bytes one by one, instead of loading the whole
+	 * word, lets the loads be forwarded from the byte stores */
+	for (i = 0, ret = 0; i < n; i++)
+		ret |= (uint64_t)b[i] << (8*i);
+
+	return ret;
+}
+
+_static_inline cube_swar_t
+load_swar(cube_t c)
+{
+	cube_swar_t ret;
+
+	ret.corner = bytestoword_swar(c.corner, 8);
+	ret.edge[0] = bytestoword_swar(c.edge, 8);
+	ret.edge[1] = bytestoword_swar(c.edge + 8, 4);
+
+	return ret;
+}
+
+_static_inline cube_t
+store_swar(cube_swar_t c)
+{
+	cube_t ret;
+
+	wordtobytes_swar(c.corner, ret.corner, 8);
+	wordtobytes_swar(c.edge[0], ret.edge, 8);
+	wordtobytes_swar(c.edge[1], ret.edge + 8, 4);
+
+	return ret;
+}
+
+_static_inline bool
+equal_swar(cube_swar_t c1, cube_swar_t c2)
+{
+	return ((c1.corner ^ c2.corner) |
+	    (c1.edge[0] ^ c2.edge[0]) |
+	    (c1.edge[1] ^ c2.edge[1])) == 0;
+}
+
+/*
+ * The first byte of cube_t is the lowest one of the word, so the word with
+ * the lowest nonzero byte of a ^ b is found first, and then only that byte
+ * is compared.
+ */
+_static_inline bool
+lessword_swar(uint64_t a, uint64_t b)
+{
+	uint64_t x;
+
+	x = a ^ b;
+	x |= x >> 4;
+	x |= x >> 2;
+	x |= x >> 1;
+	x &= UINT64_C(0x0101010101010101);
+	x = (x & -x) * 0xFF;
+
+	return (a & x) < (b & x);
+}
+
+_static_inline bool
+less_swar(cube_swar_t c1, cube_swar_t c2)
+{
+	if (c1.corner != c2.corner)
+		return lessword_swar(c1.corner, c2.corner);
+	if (c1.edge[0] != c2.edge[0])
+		return lessword_swar(c1.edge[0], c2.edge[0]);
+	return lessword_swar(c1.edge[1], c2.edge[1]);
+}
+
+_static_inline bool
+issolved_swar(cube_swar_t c)
+{
+	return equal_swar(c, solved_swar);
+}
+
+_static_inline uint64_t
+invertcocorners_swar(uint64_t corner)
+{
+	uint64_t co, swapped;
+
+	co = corner & _co_swar;
+	swapped = ((co << 1) | (co >> 1)) & _co_swar;
+
+	return (corner & ~_co_swar) | swapped;
+}
+
+_static_inline cube_swar_t
+invertco_swar(cube_swar_t c)
+{
+	c.corner = invertcocorners_swar(c.corner);
+
+	return c;
+}
+
+_static_inline uint64_t
+composecorners_swar(uint64_t c1, uint64_t c2)
+{
+	uint8_t b[8];
+	uint64_t s, aux, auy;
+
+	wordtobytes_swar(c1, b, 8);
+
+	/* Same as in the portable version, done on all bytes at once.
+	 * No byte overflows, so there are no carries between bytes. */
+	s = gather_swar(b, c2, 8);
+	aux = (s & _co_swar) + (c2 & _co_swar);
+	auy = ((aux + _cocw_swar) >> 2) & _coshr_swar;
+
+	return (s & _p_swar) | ((aux + auy) & _co_swar);
+}
+
+_static_inline void
+composeedges_swar(const uint64_t c1[2], const uint64_t c2[2], uint64_t ret[2])
+{
+	uint8_t b[16];
+
+	wordtobytes_swar(c1[0], b, 8);
+	wordtobytes_swar(c1[1], b + 8, 8);
+
+	ret[0] = gather_swar(b, c2[0], 8) ^ (c2[0] & _eo_swar);
+	ret[1] = gather_swar(b, c2[1], 4) ^ (c2[1] & _eo_swar);
+}
+
+_static_inline cube_swar_t
+compose_swar(cube_swar_t c1, cube_swar_t c2)
+{
+	cube_swar_t ret;
+
+	composeedges_swar(c1.edge, c2.edge, ret.edge);
+	ret.corner = composecorners_swar(c1.corner, c2.corner);
+
+	return ret;
+}
+
+_static_inline cube_swar_t
+inverse_swar(cube_swar_t c)
+{
+	/*
+	 * The inverse moves each piece to the position given by its value,
+	 * which words cannot do in one step: the pieces are scattered in a
+	 * byte buffer, as in the portable version. This is only about 1.3
+	 * times faster than the portable backend. Placing the pieces in the
+	 * words with variable shifts instead is slower.
+	 */
+	int i;
+	uint8_t b[20];
+	uint64_t piece;
+	cube_swar_t ret;
+
+	for (i = 0; i < 8; i++) {
+		piece = c.corner >> (8*i);
+		b[piece & _pbits] = i | (piece & _cobits2);
+	}
+	for (i = 0; i < 8; i++) {
+		piece = c.edge[0] >> (8*i);
+		b[8 + (piece & _pbits)] = i | (piece & _eobit);
+	}
+	for (i = 0; i < 4; i++) {
+		piece = c.edge[1] >> (8*i);
+		b[8 + (piece & _pbits)] = (i + 8) | (piece & _eobit);
+	}
+
+	ret.corner = collect_swar(b, 8);
+	ret.edge[0] = collect_swar(b + 8, 8);
+	ret.edge[1] = collect_swar(b + 16, 4);
+
+	return invertco_swar(ret);
+}
+
+_static_inline cube_swar_t
+movecube_swar(move_t m)
+{
+	return move_table_swar[m];
+}
+
+_static_inline cube_swar_t
+transcube_swar(trans_t t, int inverse)
+{
+	return trans_table_swar[t][inverse];
+}
+
+_static_inline cube_swar_t
+move_swar(cube_swar_t c, move_t m)
+{
+	return compose_swar(c, movecube_swar(m));
+}
+
+_static_inline cube_swar_t
+transform_swar(cube_swar_t c, trans_t t)
+{
+	cube_swar_t ret;
+
+	ret = compose_swar(compose_swar(transcube_swar(t, NORMAL), c),
+	    transcube_swar(t, INVERSE));
+
+	return t < 24 ? ret : invertco_swar(ret);
+}
+
+/*
+ * See _backend. The corners come first in cube_t and almost always decide,
+ * so the edge words are only computed when the corner word is not larger
+ * than that of best.
+ */
+_static_inline bool
+transformmin_swar(cube_swar_t c, trans_t t, cube_swar_t *best)
+{
+	uint64_t aux[2];
+	cube_swar_t tcube, tinv, ret;
+
+	tcube = transcube_swar(t, NORMAL);
+	tinv = transcube_swar(t, INVERSE);
+	ret.corner = composecorners_swar(
+	    composecorners_swar(tcube.corner, c.corner), tinv.corner);
+	if (t >= 24)
+		ret.corner = invertcocorners_swar(ret.corner);
+	if (ret.corner != best->corner &&
+	    !lessword_swar(ret.corner, best->corner))
+		return false;
+
+	composeedges_swar(tcube.edge, c.edge, aux);
+	composeedges_swar(aux, tinv.edge, ret.edge);
+	if (!less_swar(ret, *best))
+		return false;
+
+	*best = ret;
+	return true;
+}
+
+_static_inline void
+soa_transform_swar(const cube_soa_t *c, trans_t t, cube_soa_t *out)
+{
+	soa_transform(c, t, out);
+}
+
+_backend(swar, cube_swar_t, )
+
+#endif
+
+#ifdef CUBE_BACKEND_PORTABLE
+
+/*
+ * Portable backend, one byte per piece as in cube_t.
+ */
+
+_static_inline cube_t
+load_portable(cube_t c)
+{
+	return c;
+}
+
+_static_inline cube_t
+store_portable(cube_t c)
+{
+	return c;
+}
+
+/* cube_t has no padding, and compilers compare it a word at a time */
+_static_inline bool
+equal_portable(cube_t c1, cube_t c2)
+{
+	return memcmp(&c1, &c2, sizeof(cube_t)) == 0;
+}
+
+_static_inline bool
+less_portable(cube_t c1, cube_t c2)
+{
+	return memcmp(&c1, &c2, sizeof(cube_t)) < 0;
+}
+
+_static_inline bool
+issolved_portable(cube_t c)
+{
+	return equal_portable(c, solved);
+}
+
+_static_inline cube_t
+invertco_portable(cube_t c)
+{
+	uint8_t i, piece, orien;
+	cube_t ret;
+
+	ret = c;
+	for (i = 0; i < 8; i++) {
+		piece = c.corner[i];
+		orien = ((piece << 1) | (piece >> 1)) & _cobits2;
+		ret.corner[i] = (piece & _pbits) | orien;
+	}
+
+	return ret;
+}
+
+_static_inline cube_t
+compose_portable(cube_t c1, cube_t c2)
+{
+	uint8_t i, piece2;
+	cube_t ret;
+
+	for (i = 0; i < 12; i++) {
+		piece2 = c2.edge[i];
+		ret.edge[i] = composeedge(c1.edge[piece2 & _pbits], piece2);
+	}
+
+	for (i = 0; i < 8; i++) {
+		piece2 = c2.corner[i];
+		ret.corner[i] = composecorner(c1.corner[piece2 & _pbits], piece2);
+	}
+
+	return ret;
+}
+
+_static_inline cube_t
+inverse_portable(cube_t c)
+{
+	cube_t ret;
+	uint8_t i, piece, orien;
+
+	ret = zero;
+
+	for (i = 0; i < 12; i++) {
+		piece = c.edge[i];
+		orien = piece & _eobit;
 		ret.edge[piece & _pbits] = i | orien;
 	}
 
 	for (i = 0; i < 8; i++) {
-		piece = cube.corner[i];
+		piece = c.corner[i];
 		orien = ((piece << 1) | (piece >> 1)) & _cobits2;
 		ret.corner[piece & _pbits] = i | orien;
 	}
@@ -503,23 +1444,565 @@ cube_inverse(cube_t cube)
 	return ret;
 }
 
-cube_t
-cube_move(cube_t c, move_t m)
+_static_inline cube_t
+movecube_portable(move_t m)
+{
+	return move_table[m];
+}
+
+_static_inline cube_t
+transcube_portable(trans_t t, int inverse)
+{
+	return trans_table[t][inverse];
+}
+
+_static_inline cube_t
+move_portable(cube_t c, move_t m)
+{
+	return compose_portable(c, movecube_portable(m));
+}
+
+_static_inline cube_t
+transform_portable(cube_t c, trans_t t)
+{
+	cube_t tcube, tinv;
+
+	tcube = transcube_portable(t, NORMAL);
+	tinv = transcube_portable(t, INVERSE);
+
+	return t < 24 ?
+	    compose_portable(compose_portable(tcube, c), tinv) :
+	    invertco_portable(compose_portable(compose_portable(tcube, c), tinv));
+}
+
+/*
+ * See _backend. The corners come first in cube_t and almost always decide,
+ * so the edges are only computed when the corners are not larger than those
+ * of best.
+ */
+_static_inline bool
+transformmin_portable(cube_t c, trans_t t, cube_t *best)
+{
+	uint8_t i, piece1, piece2;
+	const cube_t *tcube, *tinv;
+	cube_t ret;
+
+	tcube = &trans_table[t][NORMAL];
+	tinv = &trans_table[t][INVERSE];
+	for (i = 0; i < 8; i++) {
+		piece2 = tinv->corner[i];
+		piece1 = c.corner[piece2 & _pbits];
+		ret.corner[i] = composecorner(
+		    composecorner(tcube->corner[piece1 & _pbits], piece1),
+		    piece2);
+		if (t >= 24)
+			ret.corner[i] = (ret.corner[i] & _pbits) |
+			    (((ret.corner[i] << 1) | (ret.corner[i] >> 1)) &
+			    _cobits2);
+	}
+	if (memcmp(ret.corner, best->corner, 8) > 0)
+		return false;
+
+	for (i = 0; i < 12; i++) {
+		piece2 = tinv->edge[i];
+		piece1 = c.edge[piece2 & _pbits];
+		ret.edge[i] = composeedge(
+		    composeedge(tcube->edge[piece1 & _pbits], piece1), piece2);
+	}
+	if (!less_portable(ret, *best))
+		return false;
+
+	*best = ret;
+	return true;
+}
+
+_static_inline void
+soa_transform_portable(const cube_soa_t *c, trans_t t, cube_soa_t *out)
+{
+	soa_transform(c, t, out);
+}
+
+_backend(portable, cube_t, )
+
+#endif
+
+#if defined(CUBE_DISPATCH)
+
+_static const backend_t *backend = &backend_portable;
+
+_static void choosebackend(void) __attribute__((constructor));
+
+_static bool
+supported_always(void)
+{
+	return true;
+}
+
+#ifdef CUBE_BACKEND_AVX2
+_static bool
+supported_avx2(void)
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+}
+#endif
+
+/* From the slowest to the fastest, each with the check for its CPU */
+_static const struct {
+	const backend_t *backend;
+	bool (*supported)(void);
+} allbackends[] = {
+	{ &backend_portable, supported_always },
+	{ &backend_swar, supported_always },
+#ifdef CUBE_BACKEND_AVX2
+	{ &backend_avx2, supported_avx2 },
+#endif
+};
+
+_static void
+choosebackend(void)
+{
+	size_t i, n;
+	const char *env;
+
+	n = sizeof(allbackends) / sizeof(allbackends[0]);
+	for (i = 0; i < n; i++)
+		if (allbackends[i].supported())
+			backend = allbackends[i].backend;
+
+	/* Mostly for testing and benchmarking each backend */
+	if ((env = getenv("CUBE_BACKEND")) == NULL)
+		return;
+	for (i = 0; i < n; i++) {
+		if (strcmp(env, allbackends[i].backend->name))
+			continue;
+		if (allbackends[i].supported())
+			backend = allbackends[i].backend;
+		else
+			fprintf(stderr, "Warning: CUBE_BACKEND=%s is not "
+			    "supported by this CPU, using %s\n",
+			    env, backend->name);
+	}
+}
+
+#elif defined(CUBE_BACKEND_AVX2)
+_static const backend_t *const backend = &backend_avx2;
+#elif defined(CUBE_BACKEND_SWAR)
+_static const backend_t *const backend = &backend_swar;
+#else
+_static const backend_t *const backend = &backend_portable;
+#endif
+
+
+_static int
+permsign(uint8_t *a, int n)
+{
+	int i, j;
+	uint8_t ret = 0;
+
+	for (i = 0; i < n; i++)
+		for (j = i+1; j < n; j++)
+			ret += a[i] > a[j] ? 1 : 0;
+
+	return ret % 2;
+}
+
+_static int64_t
+permrank(const uint8_t *a, int n)
+{
+	int i, j, c;
+	int64_t ret;
+
+	/* Only the relative order of the pieces matters */
+	for (ret = 0, i = 0; i < n; i++) {
+		for (c = 0, j = i+1; j < n; j++)
+			c += (a[j] & _pbits) < (a[i] & _pbits) ? 1 : 0;
+		ret += c * factorial[n-1-i];
+	}
+
+	return ret;
+}
+
+_static void
+permunrank(int64_t r, uint8_t *a, int n)
+{
+	int i, j, c;
+	bool used[12] = {0};
+
+	for (i = 0; i < n; i++) {
+		c = r / factorial[n-1-i];
+		r %= factorial[n-1-i];
+		for (j = 0; used[j] || c > 0; j++)
+			if (!used[j])
+				c--;
+		a[i] = j;
+		used[j] = true;
+	}
+}
+
+/*
+ * Digits of the rank of a permutation of 0, ..., n-1 with n at most 12, as
+ * in permrank(): the rank is the sum of d[i] * (n-1-i)!. Nibble k of less
+ * counts the pieces smaller than k seen so far, so that each digit takes a
+ * few operations and no loop.
+ */
+_static void
+permdigits(const uint8_t *a, int n, int *d)
+{
+	int i, p;
+	uint64_t less;
+
+	for (i = 0, less = 0; i < n; i++) {
+		p = a[i] & _pbits;
+		d[i] = p - ((less >> (4*p)) & 0xF);
+		less += UINT64_C(0x111111111111) << (4*(p+1));
+	}
+}
+
+/* The inverse of permdigits(), nibble k of left is the k-th unused piece */
+_static void
+permfromdigits(const int *d, int n, uint8_t *a)
+{
+	int i, s;
+	uint64_t left;
+
+	for (i = 0, left = UINT64_C(0xBA9876543210); i < n; i++) {
+		s = 4 * d[i];
+		a[i] = (left >> s) & 0xF;
+		left = (left & ((UINT64_C(1) << s) - 1)) | ((left >> (s+4)) << s);
+	}
+}
+
+/*
+ * Rank of the set of marked positions among n. Positions are counted from
+ * the last one, so that the last k positions have rank 0.
+ */
+_static int64_t
+combrank(const bool *set, int n)
+{
+	int q, k;
+	int64_t ret;
+
+	for (ret = 0, q = 0, k = 0; q < n; q++)
+		if (set[n-1-q])
+			ret += binomial[q][++k];
+
+	return ret;
+}
+
+_static void
+combunrank(int64_t r, int n, int k, bool *set)
+{
+	int q;
+
+	memset(set, 0, n * sizeof(bool));
+	for (q = n-1; k > 0; q--) {
+		if (binomial[q][k] <= r) {
+			r -= binomial[q][k];
+			set[n-1-q] = true;
+			k--;
+		}
+	}
+}
+
+/* Makes the permutation parity of corners and edges agree */
+_static cube_t
+fixparity(cube_t c, bool swapcorners)
+{
+	uint8_t i, j, *a, edges[12], corners[8];
+
+	for (i = 0; i < 12; i++)
+		edges[i] = c.edge[i] & _pbits;
+	for (i = 0; i < 8; i++)
+		corners[i] = c.corner[i] & _pbits;
+	if (permsign(edges, 12) == permsign(corners, 8))
+		return c;
+
+	/* Swap the pieces 0 and 1, wherever they are */
+	a = swapcorners ? c.corner : c.edge;
+	for (i = 0; (a[i] & _pbits) != 0; i++) ;
+	for (j = 0; (a[j] & _pbits) != 1; j++) ;
+	a[i] = (a[i] & ~_pbits) | 1;
+	a[j] = (a[j] & ~_pbits) | 0;
+
+	return c;
+}
+
+cube_t
+cube_new(void)
+{
+	return solved;
+}
+
+cube_t
+cube_clone(cube_t c)
+{
+	cube_t ret;
+
+	memcpy(&ret, &c, sizeof(cube_t));
+
+	return ret;
+}
+
+bool
+cube_consistent(cube_t cube)
+{
+	uint8_t i, p, e, piece;
+	uint16_t found;
+
+	for (i = 0, found = 0; i < 12; i++) {
+		piece = cube.edge[i];
+		p = piece & _pbits;
+		e = piece & _eobit;
+		if (p >= 12)
+			goto inconsistent_ep;
+		if (e != 0 && e != _eobit)
+			goto inconsistent_eo;
+		found |= 1U << p;
+	}
+	if (found != 0xFFFU)
+		goto inconsistent_ep;
+
+	for (i = 0, found = 0; i < 8; i++) {
+		piece = cube.corner[i];
+		p = piece & _pbits;
+		e = piece & _cobits;
+		if (p >= 8)
+			goto inconsistent_cp;
+		if (e != 0 && e != _ctwist_cw && e != _ctwist_ccw)
+			goto inconsistent_co;
+		found |= 1U << p;
+	}
+	if (found != 0xFFU)
+		goto inconsistent_co;
+
+	return true;
+
+inconsistent_ep:
+	DBG_LOG("Inconsistent EP\n");
+	return false;
+inconsistent_cp:
+	DBG_LOG("Inconsistent CP\n");
+	return false;
+inconsistent_eo:
+	DBG_LOG("Inconsistent EO\n");
+	return false;
+inconsistent_co:
+	DBG_LOG("Inconsistent CO\n");
+	return false;
+}
+
+bool
+cube_solvable(cube_t cube)
+{
+	uint8_t i, eo, co, piece, edges[12], corners[8];
+
+	DBG_ASSERT(cube_consistent(cube), false,
+	    "cube_solvable: cube is inconsistent\n");
+
+	for (i = 0; i < 12; i++)
+		edges[i] = cube.edge[i] & _pbits;
+	for (i = 0; i < 8; i++)
+		corners[i] = cube.corner[i] & _pbits;
+
+	if (permsign(edges, 12) != permsign(corners, 8))
+		goto solvable_parity;
+
+	eo = 0;
+	for (i = 0; i < 12; i++) {
+		piece = cube.edge[i];
+		eo += (piece & _eobit) >> _eoshift;
+	}
+	if (eo % 2 != 0)
+		goto solvable_eo;
+
+	co = 0;
+	for (i = 0; i < 8; i++) {
+		piece = cube.corner[i];
+		co += (piece & _cobits) >> _coshift;
+	}
+	if (co % 3 != 0)
+		goto solvable_co;
+
+	return true;
+
+solvable_parity:
+	DBG_LOG("EP and CP parities are different\n");
+	return false;
+solvable_eo:
+	DBG_LOG("Odd number of flipped edges\n");
+	return false;
+solvable_co:
+	DBG_LOG("Sum of corner orientation is not multiple of 3\n");
+	return false;
+}
+
+bool
+cube_solved(cube_t cube)
+{
+	return backend->solved(cube);
+}
+
+/*
+ * Equality does not depend on the representation of the backend, and
+ * loading the cubes in it would take longer than comparing them as words
+ */
+bool
+cube_equal(cube_t c1, cube_t c2)
+{
+	return memcmp(&c1, &c2, sizeof(cube_t)) == 0;
+}
+
+/*
+ * The cube is read as three words, which are mixed together and then with
+ * the finalizer of MurmurHash3. The result depends on the byte order of
+ * the machine.
+ */
+uint64_t
+cube_hash(cube_t c)
+{
+	uint32_t e2;
+	uint64_t co, e1, h;
+
+	memcpy(&co, c.corner, 8);
+	memcpy(&e1, c.edge, 8);
+	memcpy(&e2, c.edge + 8, 4);
+
+	h = co * UINT64_C(0x9E3779B97F4A7C15);
+	h ^= (h >> 29) ^ e1 * UINT64_C(0xC2B2AE3D27D4EB4F);
+	h ^= (h >> 31) ^ e2 * UINT64_C(0x165667B19E3779F9);
+	h ^= h >> 33;
+	h *= UINT64_C(0xFF51AFD7ED558CCD);
+	h ^= h >> 33;
+	h *= UINT64_C(0xC4CEB9FE1A85EC53);
+	h ^= h >> 33;
+
+	return h;
+}
+
+bool
+cube_error(cube_t cube)
+{
+	return cube_equal(cube, zero);
+}
+
+cube_t
+cube_compose(cube_t c1, cube_t c2)
+{
+	DBG_ASSERT(cube_consistent(c1) && cube_consistent(c2),
+	    zero, "cube_compose error: inconsistent cube\n")
+
+	return backend->compose(c1, c2);
+}
+
+cube_t
+cube_inverse(cube_t cube)
+{
+	DBG_ASSERT(cube_consistent(cube), zero,
+	    "cube_inverse error: inconsistent cube\n");
+
+	return backend->inverse(cube);
+}
+
+cube_t
+cube_move(cube_t c, move_t m)
+{
+	DBG_ASSERT(cube_consistent(c), zero,
+	    "cube_move error: inconsistent cube\n");
+
+	return backend->move(c, m);
+}
+
+cube_t
+cube_transform(cube_t c, trans_t t)
+{
+	DBG_ASSERT(cube_consistent(c), zero,
+	    "cube_transform error: inconsistent cube\n");
+
+	return backend->transform(c, t);
+}
+
+cube_t
+cube_canonical(cube_t c, bool inverse, trans_t *t, bool *inverted)
+{
+	DBG_ASSERT(cube_consistent(c), zero,
+	    "cube_canonical error: inconsistent cube\n");
+
+	return backend->canonical(c, inverse, t, inverted);
+}
+
+void
+cube_compose_batch(const cube_t *c1, const cube_t *c2, size_t n, cube_t *out)
+{
+	backend->compose_batch(c1, c2, n, out);
+}
+
+void
+cube_move_batch(const cube_t *c, move_t m, size_t n, cube_t *out)
+{
+	backend->move_batch(c, m, n, out);
+}
+
+void
+cube_transform_batch(const cube_t *c, trans_t t, size_t n, cube_t *out)
+{
+	backend->transform_batch(c, t, n, out);
+}
+
+void
+cube_soa_init(cube_soa_t *soa, size_t n, uint8_t *buf)
+{
+	int i;
+
+	soa->n = n;
+	for (i = 0; i < 8; i++)
+		soa->corner[i] = buf + i*n;
+	for (i = 0; i < 12; i++)
+		soa->edge[i] = buf + (8+i)*n;
+}
+
+void
+cube_soa_load(cube_soa_t *soa, const cube_t *cubes)
+{
+	size_t i, k;
+
+	for (i = 0; i < 8; i++)
+		for (k = 0; k < soa->n; k++)
+			soa->corner[i][k] = cubes[k].corner[i];
+	for (i = 0; i < 12; i++)
+		for (k = 0; k < soa->n; k++)
+			soa->edge[i][k] = cubes[k].edge[i];
+}
+
+void
+cube_soa_store(const cube_soa_t *soa, cube_t *cubes)
 {
-	return cube_compose(c, move_table[m]);
+	size_t i, k;
+
+	for (i = 0; i < 8; i++)
+		for (k = 0; k < soa->n; k++)
+			cubes[k].corner[i] = soa->corner[i][k];
+	for (i = 0; i < 12; i++)
+		for (k = 0; k < soa->n; k++)
+			cubes[k].edge[i] = soa->edge[i][k];
 }
 
-cube_t
-cube_transform(cube_t c, trans_t t)
+void
+cube_soa_move(const cube_soa_t *c, move_t m, cube_soa_t *out)
 {
-	cube_t tcube, tinv;
+	DBG_ASSERT(c->n == out->n, ,
+	    "cube_soa_move error: sizes do not match\n");
 
-	tcube = trans_table[t][NORMAL];
-	tinv = trans_table[t][INVERSE];
+	backend->soa_move(c, m, out);
+}
 
-	return t < 24 ?
-	    cube_compose(cube_compose(tcube, c), tinv) :
-	    invertco(cube_compose(cube_compose(tcube, c), tinv));
+void
+cube_soa_transform(const cube_soa_t *c, trans_t t, cube_soa_t *out)
+{
+	DBG_ASSERT(c->n == out->n, ,
+	    "cube_soa_transform error: sizes do not match\n");
+
+	backend->soa_transform(c, t, out);
 }
 
 int64_t
@@ -546,6 +2029,337 @@ cube_coord_eo(cube_t c)
 	return ret;
 }
 
+int64_t
+cube_coord_eslice(cube_t c)
+{
+	int i;
+	bool set[12];
+
+	for (i = 0; i < 12; i++)
+		set[i] = c.edge[i] & _esepbit2;
+
+	return combrank(set, 12);
+}
+
+int64_t
+cube_coord_cp(cube_t c)
+{
+	return permrank(c.corner, 8);
+}
+
+int64_t
+cube_coord_epud(cube_t c)
+{
+	return permrank(c.edge, 8);
+}
+
+int64_t
+cube_coord_epe(cube_t c)
+{
+	return permrank(c.edge + 8, 4);
+}
+
+int64_t
+cube_coord_ep(cube_t c)
+{
+	return permrank(c.edge, 12);
+}
+
+int64_t
+cube_coord_csep(cube_t c)
+{
+	int i;
+	bool set[8];
+
+	for (i = 0; i < 8; i++)
+		set[i] = c.corner[i] & _csepbit;
+
+	return combrank(set, 8);
+}
+
+int64_t
+cube_coord_esep(cube_t c)
+{
+	int i, j;
+	bool set[12], set8[8];
+
+	for (i = 0, j = 0; i < 12; i++) {
+		set[i] = c.edge[i] & _esepbit2;
+		if (!set[i])
+			set8[j++] = c.edge[i] & _esepbit1;
+	}
+
+	return combrank(set, 12) * _8c4 + combrank(set8, 8);
+}
+
+/*
+ * The inverse coordinate functions return a solvable cube with the given
+ * coordinate. The pieces that the coordinate does not describe are placed
+ * in order, except for a swap of the pieces 0 and 1 that may be needed to
+ * fix the permutation parity.
+ */
+
+cube_t
+cube_invcoord_co(int64_t coord)
+{
+	int i, co, sum;
+	cube_t ret;
+
+	DBG_ASSERT(coord >= 0 && coord < _3p7, zero,
+	    "cube_invcoord_co error: invalid coordinate %" PRId64 "\n", coord);
+
+	ret = solved;
+	for (i = 0, sum = 0; i < 7; i++, coord /= 3) {
+		co = coord % 3;
+		sum += co;
+		ret.corner[i] |= co << _coshift;
+	}
+	ret.corner[7] |= ((3 - sum % 3) % 3) << _coshift;
+
+	return ret;
+}
+
+cube_t
+cube_invcoord_eo(int64_t coord)
+{
+	int i, eo, sum;
+	cube_t ret;
+
+	DBG_ASSERT(coord >= 0 && coord < _2p11, zero,
+	    "cube_invcoord_eo error: invalid coordinate %" PRId64 "\n", coord);
+
+	ret = solved;
+	for (i = 1, sum = 0; i < 12; i++, coord /= 2) {
+		eo = coord % 2;
+		sum += eo;
+		ret.edge[i] |= eo << _eoshift;
+	}
+	ret.edge[0] |= (sum % 2) << _eoshift;
+
+	return ret;
+}
+
+cube_t
+cube_invcoord_eslice(int64_t coord)
+{
+	int i, e, o;
+	bool set[12];
+	cube_t ret;
+
+	DBG_ASSERT(coord >= 0 && coord < _12c4, zero,
+	    "cube_invcoord_eslice error: invalid coordinate %" PRId64 "\n",
+	    coord);
+
+	ret = solved;
+	combunrank(coord, 12, 4, set);
+	for (i = 0, e = 8, o = 0; i < 12; i++)
+		ret.edge[i] = set[i] ? e++ : o++;
+
+	return fixparity(ret, false);
+}
+
+cube_t
+cube_invcoord_cp(int64_t coord)
+{
+	cube_t ret;
+
+	DBG_ASSERT(coord >= 0 && coord < factorial[8], zero,
+	    "cube_invcoord_cp error: invalid coordinate %" PRId64 "\n", coord);
+
+	ret = solved;
+	permunrank(coord, ret.corner, 8);
+
+	return fixparity(ret, false);
+}
+
+cube_t
+cube_invcoord_epud(int64_t coord)
+{
+	cube_t ret;
+
+	DBG_ASSERT(coord >= 0 && coord < factorial[8], zero,
+	    "cube_invcoord_epud error: invalid coordinate %" PRId64 "\n",
+	    coord);
+
+	ret = solved;
+	permunrank(coord, ret.edge, 8);
+
+	return fixparity(ret, true);
+}
+
+cube_t
+cube_invcoord_epe(int64_t coord)
+{
+	int i;
+	cube_t ret;
+
+	DBG_ASSERT(coord >= 0 && coord < factorial[4], zero,
+	    "cube_invcoord_epe error: invalid coordinate %" PRId64 "\n",
+	    coord);
+
+	ret = solved;
+	permunrank(coord, ret.edge + 8, 4);
+	for (i = 8; i < 12; i++)
+		ret.edge[i] += 8;
+
+	return fixparity(ret, true);
+}
+
+cube_t
+cube_invcoord_ep(int64_t coord)
+{
+	cube_t ret;
+
+	DBG_ASSERT(coord >= 0 && coord < factorial[12], zero,
+	    "cube_invcoord_ep error: invalid coordinate %" PRId64 "\n", coord);
+
+	ret = solved;
+	permunrank(coord, ret.edge, 12);
+
+	return fixparity(ret, true);
+}
+
+cube_t
+cube_invcoord_csep(int64_t coord)
+{
+	int i, a, b;
+	bool set[8];
+	cube_t ret;
+
+	DBG_ASSERT(coord >= 0 && coord < _8c4, zero,
+	    "cube_invcoord_csep error: invalid coordinate %" PRId64 "\n",
+	    coord);
+
+	ret = solved;
+	combunrank(coord, 8, 4, set);
+	for (i = 0, a = 0, b = 4; i < 8; i++)
+		ret.corner[i] = set[i] ? b++ : a++;
+
+	return fixparity(ret, false);
+}
+
+cube_t
+cube_invcoord_esep(int64_t coord)
+{
+	int i, j, a, b, e;
+	bool set[12], set8[8];
+	cube_t ret;
+
+	DBG_ASSERT(coord >= 0 && coord < _12c4 * _8c4, zero,
+	    "cube_invcoord_esep error: invalid coordinate %" PRId64 "\n",
+	    coord);
+
+	ret = solved;
+	combunrank(coord / _8c4, 12, 4, set);
+	combunrank(coord % _8c4, 8, 4, set8);
+	for (i = 0, j = 0, a = 0, b = 4, e = 8; i < 12; i++) {
+		if (set[i])
+			ret.edge[i] = e++;
+		else
+			ret.edge[i] = set8[j++] ? b++ : a++;
+	}
+
+	return fixparity(ret, false);
+}
+
+/*
+ * The rank is x * 2^11 + eo, where x is made of the corner permutation,
+ * the corner orientation and the edge permutation divided by 2, as its
+ * last digit is given by the parity of the corners.
+ */
+cube_rank_t
+cube_rank(cube_t c)
+{
+	int i, dc[8], de[12];
+	uint64_t x;
+	cube_rank_t ret;
+
+	DBG_ASSERT(cube_solvable(c), rank_error,
+	    "cube_rank error: the cube is not solvable\n");
+
+	permdigits(c.corner, 8, dc);
+	permdigits(c.edge, 12, de);
+	for (i = 0, x = 0; i < 8; i++)
+		x = x * (8-i) + dc[i];
+	x = x * _3p7 + cube_coord_co(c);
+	for (i = 0; i < 10; i++)
+		x = x * (12-i) + de[i];
+
+	ret.hi = x >> 53;
+	ret.lo = (x << 11) | cube_coord_eo(c);
+
+	return ret;
+}
+
+cube_t
+cube_unrank(cube_rank_t r)
+{
+	int i, dc[8], de[12], co, eo, sum, parity;
+	uint64_t x;
+	cube_t ret;
+
+	x = (r.hi << 53) | (r.lo >> 11);
+	if (r.hi >> 2 != 0 || x >= _nrank) {
+		DBG_LOG("cube_unrank error: rank out of range\n");
+		return zero;
+	}
+
+	for (i = 9, parity = 0; i >= 0; i--) {
+		de[i] = x % (12-i);
+		parity += de[i];
+		x /= 12-i;
+	}
+	co = x % _3p7;
+	x /= _3p7;
+	for (i = 7; i >= 0; i--) {
+		dc[i] = x % (8-i);
+		parity += dc[i];
+		x /= 8-i;
+	}
+	de[10] = parity % 2;
+	de[11] = 0;
+	permfromdigits(dc, 8, ret.corner);
+	permfromdigits(de, 12, ret.edge);
+
+	for (i = 0, sum = 0; i < 7; i++, co /= 3) {
+		sum += co % 3;
+		ret.corner[i] |= (co % 3) << _coshift;
+	}
+	ret.corner[7] |= ((3 - sum % 3) % 3) << _coshift;
+
+	eo = r.lo & (_2p11 - 1);
+	for (i = 1, sum = 0; i < 12; i++, eo /= 2) {
+		sum += eo % 2;
+		ret.edge[i] |= (eo % 2) << _eoshift;
+	}
+	ret.edge[0] |= (sum % 2) << _eoshift;
+
+	return ret;
+}
+
+void
+cube_rank_write(cube_rank_t r, uint8_t *buf)
+{
+	int i;
+
+	buf[0] = r.hi & 0xFF;
+	for (i = 0; i < 8; i++)
+		buf[8-i] = (r.lo >> (8*i)) & 0xFF;
+}
+
+cube_rank_t
+cube_rank_read(const uint8_t *buf)
+{
+	int i;
+	cube_rank_t r;
+
+	r.hi = buf[0];
+	for (i = 1, r.lo = 0; i < 9; i++)
+		r.lo = (r.lo << 8) | buf[i];
+
+	return r;
+}
+
 cube_t
 cube_read(const char *format, const char *buf)
 {
@@ -593,6 +2407,263 @@ write_error:
 	buf[len+1] = '\0';
 }
 
+size_t
+cube_readbulk(const char *format, const char *buf, size_t len, size_t n,
+    cube_t *cubes, cube_codec_error_t *err, size_t *used)
+{
+	size_t i;
+	cube_codec_error_t e;
+	const char *b, *end, *eol;
+	cube_codec_error_t (*readline)(const char *, const char *, cube_t *);
+
+	if (!strcmp(format, "H48")) {
+		readline = readline_H48;
+	} else if (!strcmp(format, "LST")) {
+		readline = readline_LST;
+	} else {
+		DBG_LOG("Cannot read cubes in the given format\n");
+		if (used != NULL)
+			*used = 0;
+		return 0;
+	}
+
+	for (i = 0, b = buf, end = buf + len; i < n && b < end; i++) {
+		if ((eol = memchr(b, '\n', end - b)) == NULL)
+			eol = end;
+		if ((e = readline(b, eol, &cubes[i])) != CUBE_CODEC_OK)
+			cubes[i] = zero;
+		if (err != NULL)
+			err[i] = e;
+		b = eol == end ? end : eol + 1;
+	}
+
+	if (used != NULL)
+		*used = b - buf;
+	return i;
+}
+
+size_t
+cube_writebulk(const char *format, const cube_t *cubes, size_t n, char *buf,
+    cube_codec_error_t *err)
+{
+	size_t i, len;
+	char *b;
+	const char *errormsg = "ERROR: cannot write inconsistent cube";
+	size_t (*write)(cube_t, char *);
+
+	if (!strcmp(format, "H48")) {
+		write = write_H48;
+	} else if (!strcmp(format, "LST")) {
+		write = write_LST;
+	} else {
+		DBG_LOG("Cannot write cubes in the given format\n");
+		*buf = '\0';
+		return 0;
+	}
+
+	for (i = 0, b = buf; i < n; i++) {
+		if (cube_consistent(cubes[i])) {
+			len = write(cubes[i], b);
+			if (err != NULL)
+				err[i] = CUBE_CODEC_OK;
+		} else {
+			len = strlen(errormsg);
+			memcpy(b, errormsg, len);
+			if (err != NULL)
+				err[i] = CUBE_CODEC_INCONSISTENT;
+		}
+		b[len] = '\n';
+		b += len + 1;
+	}
+	*b = '\0';
+
+	return b - buf;
+}
+
+int
+cube_stream_writer_init(cube_stream_writer_t *w, int flags,
+    uint32_t blocksize, uint8_t *buf,
+    size_t (*write)(const void *, size_t, void *), void *arg)
+{
+	uint8_t h[_stream_header];
+
+	if (blocksize == 0 || (flags & ~CUBE_STREAM_MOVES)) {
+		DBG_LOG("cube stream: invalid flags or block size\n");
+		return -1;
+	}
+
+	w->flags = flags;
+	w->blocksize = blocksize;
+	w->write = write;
+	w->arg = arg;
+	w->buf = buf;
+	w->len = _stream_blockheader;
+	w->n = 0;
+	w->count = 0;
+	w->error = false;
+
+	memcpy(h, _stream_magic, 8);
+	h[8] = _stream_version;
+	h[9] = flags;
+	h[10] = h[11] = 0;
+	writeuint(h + 12, blocksize, 4);
+
+	return stream_output(w, h, _stream_header);
+}
+
+int
+cube_stream_write(cube_stream_writer_t *w, cube_t cube, const move_t *moves,
+    size_t nmoves)
+{
+	size_t i;
+
+	if (w->error)
+		return -1;
+	if (!cube_consistent(cube)) {
+		DBG_LOG("cube stream: cannot write inconsistent cube\n");
+		return -1;
+	}
+	if (w->flags & CUBE_STREAM_MOVES) {
+		if (nmoves > CUBE_STREAM_MAXMOVES || (nmoves > 0 && moves == NULL))
+			goto cube_stream_write_error;
+		for (i = 0; i < nmoves; i++)
+			if ((unsigned)moves[i] > B3)
+				goto cube_stream_write_error;
+	}
+
+	writecube_stream(cube, w->buf + w->len);
+	w->len += _stream_cube;
+	if (w->flags & CUBE_STREAM_MOVES) {
+		w->buf[w->len++] = nmoves;
+		for (i = 0; i < nmoves; i++)
+			w->buf[w->len++] = moves[i];
+	}
+	w->count++;
+
+	return ++w->n == w->blocksize ? stream_flush(w) : 0;
+
+cube_stream_write_error:
+	DBG_LOG("cube stream: invalid moves\n");
+	return -1;
+}
+
+int
+cube_stream_writer_close(cube_stream_writer_t *w)
+{
+	uint8_t end[_stream_blockheader] = {0};
+
+	if (w->n > 0)
+		stream_flush(w);
+
+	return stream_output(w, end, _stream_blockheader);
+}
+
+int
+cube_stream_reader_init(cube_stream_reader_t *r, const void *buf, size_t len)
+{
+	size_t cubebytes;
+	const uint8_t *b;
+
+	b = buf;
+	if (len < _stream_header || memcmp(b, _stream_magic, 8) ||
+	    b[8] != _stream_version || (b[9] & ~CUBE_STREAM_MOVES) ||
+	    readuint(b + 12, 4) == 0) {
+		DBG_LOG("cube stream: invalid header\n");
+		return -1;
+	}
+
+	/* The size of a full block must fit in size_t, see cube_stream_seek */
+	cubebytes = CUBE_STREAM_BUFSIZE(1, b[9]) - _stream_blockheader;
+	if (readuint(b + 12, 4) > (SIZE_MAX - _stream_blockheader) / cubebytes) {
+		DBG_LOG("cube stream: block size too large\n");
+		return -1;
+	}
+
+	r->buf = b;
+	r->len = len;
+	r->flags = b[9];
+	r->blocksize = readuint(b + 12, 4);
+	r->index = 0;
+
+	return stream_block(r, _stream_header);
+}
+
+int
+cube_stream_read(cube_stream_reader_t *r, cube_t *cube, move_t *moves,
+    size_t *nmoves)
+{
+	size_t i, n;
+	const uint8_t *b;
+
+	if (r->left == 0 && !r->end &&
+	    (r->pos != r->blockend || stream_block(r, r->pos) == -1))
+		return -1;
+	if (r->end)
+		return 0;
+
+	b = r->buf + r->pos;
+	n = r->flags & CUBE_STREAM_MOVES ? b[_stream_cube] : 0;
+	if (stream_skip(r) == -1) {
+		DBG_LOG("cube stream: invalid cube at offset %zu\n", r->pos);
+		return -1;
+	}
+
+	*cube = readcube_stream(b);
+	if (!cube_consistent(*cube)) {
+		DBG_LOG("cube stream: inconsistent cube %" PRIu64 "\n",
+		    r->index - 1);
+		return -1;
+	}
+	for (i = 0; i < n; i++)
+		if (b[_stream_cube + 1 + i] > B3)
+			return -1;
+	if (moves != NULL)
+		for (i = 0; i < n; i++)
+			moves[i] = b[_stream_cube + 1 + i];
+	if (nmoves != NULL)
+		*nmoves = n;
+
+	return 1;
+}
+
+int
+cube_stream_seek(cube_stream_reader_t *r, uint64_t index)
+{
+	uint64_t first, block, blockbytes;
+	size_t off;
+
+	first = 0;
+	off = _stream_header;
+	if (!(r->flags & CUBE_STREAM_MOVES)) {
+		/* Full blocks can be larger than the stream, and than 2^32 */
+		blockbytes = _stream_blockheader +
+		    (uint64_t)r->blocksize * _stream_cube;
+		block = index / r->blocksize;
+		if (block > (r->len - _stream_header) / blockbytes)
+			return -1;
+		first = block * r->blocksize;
+		off += block * blockbytes;
+	}
+
+	for (;;) {
+		if (stream_block(r, off) == -1)
+			return -1;
+		r->index = first;
+		if (index < first + r->left || r->end)
+			break;
+		first += r->left;
+		off = r->blockend;
+	}
+	if (index > first + r->left)
+		return -1;
+
+	while (r->index < index)
+		if (stream_skip(r) == -1)
+			return -1;
+
+	return 0;
+}
+
 int
 cube_readmoves(const char *buf, move_t *ret)
 {
@@ -601,14 +2672,16 @@ cube_readmoves(const char *buf, move_t *ret)
 	const char *b;
 
 	for (n = 0, b = buf; *b != '\0'; b++) {
-		while (*b == ' ' || *b == '\t' || *b == '\n')
+		while (*b == ' ' || *b == '\t' || *b == '\n' || *b == '\r')
 			b++;
 		if (*b == '\0')
 			goto applymoves_finish;
 		if ((r = readmove(*b)) == _error)
 			goto applymoves_error;
-		if ((m = readmodifier(*(b+1))) != 0)
+		if ((m = readmodifier(*(b+1))) != _error)
 			b++;
+		else
+			m = 0;
 		ret[n++] = m + r;
 	}
 
@@ -655,3 +2728,9 @@ cube_inversetrans(trans_t t)
 {
 	return inverse_trans_table[t];
 }
+
+const char *
+cube_backend(void)
+{
+	return backend->name;
+}
@@ -1,6 +1,7 @@
 #ifndef CUBE_H
 #define CUBE_H
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #ifdef __cplusplus
 extern "C" {
@@ -27,6 +28,20 @@ typedef struct {
 	uint8_t edge[12];
 } cube_t;
 
+/* Result of reading or writing each cube with the bulk functions */
+typedef enum {
+	CUBE_CODEC_OK,
+	CUBE_CODEC_SYNTAX,         /* The line is not a cube in the format */
+	CUBE_CODEC_INCONSISTENT    /* The pieces do not make a cube */
+} cube_codec_error_t;
+
+/* Structure of arrays: corner[i][k] is the i-th corner of the k-th cube */
+typedef struct {
+	size_t n;
+	uint8_t *corner[8];
+	uint8_t *edge[12];
+} cube_soa_t;
+
 cube_t cube_new(void);
 cube_t cube_clone(cube_t);
 bool cube_consistent(cube_t);
@@ -34,16 +49,149 @@ bool cube_solvable(cube_t);
 bool cube_solved(cube_t);
 bool cube_equal(cube_t, cube_t);
 bool cube_error(cube_t);
+uint64_t cube_hash(cube_t);
 cube_t cube_compose(cube_t, cube_t);
 cube_t cube_inverse(cube_t);
 cube_t cube_move(cube_t, move_t);
 cube_t cube_transform(cube_t, trans_t);
 
+/*
+ * The smallest of the 48 transformations of the cube, comparing cubes as
+ * cube_t with memcmp(). If inverse is true the transformations of the
+ * inverse cube are also considered. The transformation is written in t and
+ * whether it applies to the inverse in inverted (either can be NULL), so
+ * that the result is cube_transform(c, *t), or the same with
+ * cube_inverse(c). Among equal candidates the first trans_t is chosen,
+ * with the cube itself before its inverse.
+ */
+cube_t cube_canonical(cube_t c, bool inverse, trans_t *t, bool *inverted);
+
+void cube_compose_batch(const cube_t *, const cube_t *, size_t, cube_t *);
+void cube_move_batch(const cube_t *, move_t, size_t, cube_t *);
+void cube_transform_batch(const cube_t *, trans_t, size_t, cube_t *);
+
+void cube_soa_init(cube_soa_t *, size_t, uint8_t *);
+void cube_soa_load(cube_soa_t *, const cube_t *);
+void cube_soa_store(const cube_soa_t *, cube_t *);
+void cube_soa_move(const cube_soa_t *, move_t, cube_soa_t *);
+void cube_soa_transform(const cube_soa_t *, trans_t, cube_soa_t *);
+
 int64_t cube_coord_co(cube_t);
 int64_t cube_coord_eo(cube_t);
+int64_t cube_coord_eslice(cube_t);
+int64_t cube_coord_cp(cube_t);
+int64_t cube_coord_epud(cube_t);
+int64_t cube_coord_epe(cube_t);
+int64_t cube_coord_ep(cube_t);
+int64_t cube_coord_csep(cube_t);
+int64_t cube_coord_esep(cube_t);
+
+cube_t cube_invcoord_co(int64_t);
+cube_t cube_invcoord_eo(int64_t);
+cube_t cube_invcoord_eslice(int64_t);
+cube_t cube_invcoord_cp(int64_t);
+cube_t cube_invcoord_epud(int64_t);
+cube_t cube_invcoord_epe(int64_t);
+cube_t cube_invcoord_ep(int64_t);
+cube_t cube_invcoord_csep(int64_t);
+cube_t cube_invcoord_esep(int64_t);
+
+/*
+ * Perfect ranking of the solvable cubes. cube_rank() gives each of them a
+ * different number from 0 to 43252003274489856000 - 1, ordered by corner
+ * permutation, corner orientation, edge permutation and edge orientation
+ * (the solved cube is 0). The number does not fit in 64 bits: hi holds the
+ * bits above the lowest 64. cube_unrank() gives the cube back, or the
+ * error cube for numbers out of range. cube_rank_write() and
+ * cube_rank_read() store the number in CUBE_RANK_BYTES bytes, most
+ * significant first, so that comparing the bytes compares the ranks.
+ */
+#define CUBE_RANK_BYTES 9
+
+typedef struct {
+	uint64_t hi;
+	uint64_t lo;
+} cube_rank_t;
+
+cube_rank_t cube_rank(cube_t);
+cube_t cube_unrank(cube_rank_t);
+void cube_rank_write(cube_rank_t, uint8_t *);
+cube_rank_t cube_rank_read(const uint8_t *);
 
 cube_t cube_read(const char *format, const char *buf);
 void cube_write(const char *format, cube_t cube, char *buf);
+
+/*
+ * Bulk versions of cube_read() and cube_write(), with one cube per line.
+ * cube_readbulk() reads at most n lines from the len characters of buf and
+ * returns the number of lines read; used (if not NULL) is set to the number
+ * of characters consumed. Lines that cannot be read give the error cube.
+ * cube_writebulk() writes n lines, each at most 88 characters including the
+ * newline, followed by a null character, and returns the number of
+ * characters written before it. Inconsistent cubes are written as an error
+ * message. For both, err (if not NULL) receives the result of each cube.
+ */
+size_t cube_readbulk(const char *format, const char *buf, size_t len,
+    size_t n, cube_t *cubes, cube_codec_error_t *err, size_t *used);
+size_t cube_writebulk(const char *format, const cube_t *cubes, size_t n,
+    char *buf, cube_codec_error_t *err);
+
+/*
+ * Binary streams of cubes, 13 bytes per cube, each optionally followed by a
+ * sequence of at most CUBE_STREAM_MAXMOVES moves (see cube.c for the
+ * format). The writer collects blocks of blocksize cubes in buf, which must
+ * be at least CUBE_STREAM_BUFSIZE(blocksize, flags) bytes long, and passes
+ * the header and each block to write(data, len, arg), which returns the
+ * number of bytes it wrote. The reader works on a whole stream in memory,
+ * for example a mapped file, and can seek to any cube without decoding the
+ * blocks before it. Moves can be NULL when the stream has none, or when
+ * they are not needed.
+ *
+ * The functions return 0 on success and -1 on error, except that
+ * cube_stream_read() returns 1 for each cube read and 0 at the end of the
+ * stream. Inconsistent cubes are not written. After a failed write the
+ * writer only returns errors.
+ */
+#define CUBE_STREAM_MOVES      1
+#define CUBE_STREAM_MAXMOVES   255
+#define CUBE_STREAM_BUFSIZE(blocksize, flags) \
+    (8 + (size_t)(blocksize) * ((flags) & CUBE_STREAM_MOVES ? 269 : 13))
+
+typedef struct {
+	int flags;
+	uint32_t blocksize;
+	size_t (*write)(const void *, size_t, void *);
+	void *arg;
+	uint8_t *buf;
+	size_t len;         /* Bytes in buf, including the block header */
+	uint32_t n;         /* Cubes in the current block */
+	uint64_t count;     /* Cubes written */
+	bool error;
+} cube_stream_writer_t;
+
+typedef struct {
+	const uint8_t *buf;
+	size_t len;
+	int flags;
+	uint32_t blocksize;
+	size_t pos;         /* Offset of the next cube */
+	size_t blockend;    /* Offset of the end of the current block */
+	uint32_t left;      /* Cubes left in the current block */
+	uint64_t index;     /* Index of the next cube */
+	bool end;
+} cube_stream_reader_t;
+
+int cube_stream_writer_init(cube_stream_writer_t *, int flags,
+    uint32_t blocksize, uint8_t *buf,
+    size_t (*write)(const void *, size_t, void *), void *arg);
+int cube_stream_write(cube_stream_writer_t *, cube_t, const move_t *moves,
+    size_t nmoves);
+int cube_stream_writer_close(cube_stream_writer_t *);
+int cube_stream_reader_init(cube_stream_reader_t *, const void *, size_t);
+int cube_stream_read(cube_stream_reader_t *, cube_t *, move_t *moves,
+    size_t *nmoves);
+int cube_stream_seek(cube_stream_reader_t *, uint64_t);
+
 int cube_readmoves(const char *, move_t *);
 char *cube_movestr(move_t);
 trans_t cube_readtrans(const char *);
@@ -51,6 +199,8 @@ char *cube_transstr(trans_t);
 move_t cube_inversemove(move_t);
 trans_t cube_inversetrans(trans_t);
 
+const char *cube_backend(void);
+
 
 #ifdef __cplusplus
 }
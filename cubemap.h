@@ -0,0 +1,196 @@
+#ifndef CUBEMAP_H
+#define CUBEMAP_H
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include "cube.h"
+
+/*
+ * Hash map from cubes to values of type V, which must have a default
+ * constructor. It uses open addressing with linear probing. Every slot has a
+ * one-byte tag with 7 bits of the hash of its cube, and the tags are kept in
+ * an array of their own: a lookup reads the tags of the slots it probes,
+ * which are almost always in the same cache line, and compares a cube only
+ * when its tag matches. A slot takes 21 bytes plus the size of V.
+ *
+ * The table grows when it is 7/8 full. Alternatively, insert_concurrent()
+ * can be called by many threads at once, also together with find() and
+ * contains() but not with the other functions. It never grows the table,
+ * so the caller must reserve() enough room first: it returns -1 when the
+ * table is full, 1 when the cube was added and 0 when it was already there.
+ */
+template <typename V>
+class CubeMap {
+public:
+    explicit CubeMap(size_t n = 0) { reserve(n); }
+
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+    size_t capacity() const { return limit; }
+
+    /* Makes room for n cubes in total without growing */
+    void reserve(size_t n) {
+        size_t slots = MIN_SLOTS;
+        while (slots / 8 * 7 < n)
+            slots *= 2;
+        if (tags == nullptr || slots > mask + 1)
+            rehash(slots);
+    }
+
+    void clear() {
+        for (size_t i = 0; i <= mask; i++)
+            tags[i].store(EMPTY, std::memory_order_relaxed);
+        count.store(0, std::memory_order_relaxed);
+    }
+
+    V *find(cube_t c) {
+        size_t i = lookup(c);
+        return i == NONE ? nullptr : &values[i];
+    }
+
+    const V *find(cube_t c) const {
+        size_t i = lookup(c);
+        return i == NONE ? nullptr : &values[i];
+    }
+
+    bool contains(cube_t c) const { return lookup(c) != NONE; }
+
+    /* Like std::unordered_map::insert, an existing value is kept */
+    std::pair<V *, bool> insert(cube_t c, const V &v) {
+        if (size() >= limit)
+            rehash(2 * (mask + 1));
+        uint64_t h = cube_hash(c);
+        uint8_t t = tag(h);
+        for (size_t i = h & mask; ; i = (i + 1) & mask) {
+            uint8_t x = tags[i].load(std::memory_order_relaxed);
+            if (x == EMPTY) {
+                keys[i] = c;
+                values[i] = v;
+                tags[i].store(t, std::memory_order_relaxed);
+                count.store(size() + 1, std::memory_order_relaxed);
+                return std::make_pair(&values[i], true);
+            }
+            if (x == t && equal(keys[i], c))
+                return std::make_pair(&values[i], false);
+        }
+    }
+
+    V &operator[](cube_t c) { return *insert(c, V()).first; }
+
+    int insert_concurrent(cube_t c, const V &v) {
+        uint64_t h = cube_hash(c);
+        uint8_t t = tag(h);
+        for (size_t i = h & mask; ; i = (i + 1) & mask) {
+            uint8_t x = tags[i].load(std::memory_order_acquire);
+            while (x == EMPTY) {
+                if (count.fetch_add(1, std::memory_order_relaxed) >= limit) {
+                    count.fetch_sub(1, std::memory_order_relaxed);
+                    return -1;
+                }
+                if (tags[i].compare_exchange_strong(x, BUSY, std::memory_order_acquire)) {
+                    keys[i] = c;
+                    values[i] = v;
+                    tags[i].store(t, std::memory_order_release);
+                    return 1;
+                }
+                /* Another thread took the slot, x is now its tag */
+                count.fetch_sub(1, std::memory_order_relaxed);
+            }
+            while (x == BUSY)
+                x = tags[i].load(std::memory_order_acquire);
+            if (x == t && equal(keys[i], c))
+                return 0;
+        }
+    }
+
+    /* Calls f(cube, value) for every cube in the map */
+    template <typename F>
+    void for_each(F f) {
+        for (size_t i = 0; i <= mask; i++)
+            if (tags[i].load(std::memory_order_relaxed) >= FIRST_TAG)
+                f(keys[i], values[i]);
+    }
+
+private:
+    static const size_t MIN_SLOTS = 16;
+    static const size_t NONE = (size_t)-1;
+    static const uint8_t EMPTY = 0;
+    static const uint8_t BUSY = 1;
+    static const uint8_t FIRST_TAG = 2;
+
+    std::unique_ptr<std::atomic<uint8_t>[]> tags;
+    std::unique_ptr<cube_t[]> keys;
+    std::unique_ptr<V[]> values;
+    size_t mask = 0;
+    size_t limit = 0;
+    std::atomic<size_t> count{0};
+
+    /* The low bits of the hash give the slot, the high ones the tag */
+    static uint8_t tag(uint64_t h) { return FIRST_TAG + (h >> 57); }
+
+    /* cube_t has no padding, and this compiles to three word comparisons */
+    static bool equal(const cube_t &a, const cube_t &b) {
+        return memcmp(&a, &b, sizeof(cube_t)) == 0;
+    }
+
+    size_t lookup(cube_t c) const {
+        uint64_t h = cube_hash(c);
+        uint8_t t = tag(h);
+        for (size_t i = h & mask; ; i = (i + 1) & mask) {
+            uint8_t x = tags[i].load(std::memory_order_acquire);
+            while (x == BUSY)
+                x = tags[i].load(std::memory_order_acquire);
+            if (x == EMPTY)
+                return NONE;
+            if (x == t && equal(keys[i], c))
+                return i;
+        }
+    }
+
+    void rehash(size_t slots) {
+        std::unique_ptr<std::atomic<uint8_t>[]> oldtags(std::move(tags));
+        std::unique_ptr<cube_t[]> oldkeys(std::move(keys));
+        std::unique_ptr<V[]> oldvalues(std::move(values));
+        size_t oldslots = oldtags == nullptr ? 0 : mask + 1;
+
+        tags.reset(new std::atomic<uint8_t>[slots]);
+        keys.reset(new cube_t[slots]);
+        values.reset(new V[slots]);
+        mask = slots - 1;
+        limit = slots / 8 * 7;
+        count.store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < slots; i++)
+            tags[i].store(EMPTY, std::memory_order_relaxed);
+
+        for (size_t i = 0; i < oldslots; i++)
+            if (oldtags[i].load(std::memory_order_relaxed) >= FIRST_TAG)
+                insert(oldkeys[i], oldvalues[i]);
+    }
+};
+
+/* A set of cubes, with the same functions as CubeMap */
+class CubeSet {
+public:
+    explicit CubeSet(size_t n = 0) : map(n) {}
+
+    size_t size() const { return map.size(); }
+    size_t capacity() const { return map.capacity(); }
+    void reserve(size_t n) { map.reserve(n); }
+    void clear() { map.clear(); }
+    bool contains(cube_t c) const { return map.contains(c); }
+
+    /* Returns true if the cube was not in the set */
+    bool insert(cube_t c) { return map.insert(c, true).second; }
+    int insert_concurrent(cube_t c) { return map.insert_concurrent(c, true); }
+
+    template <typename F>
+    void for_each(F f) {
+        map.for_each([&](cube_t c, bool) { f(c); });
+    }
+
+private:
+    CubeMap<bool> map;
+};
+
+#endif
@@ -1,8 +1,12 @@
+#include <algorithm>
+#include <cstring>
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <string>
 #include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "primitives.h"
 
 
@@ -15,15 +19,8 @@ const move_t drmoves[3][10] = {
     {R, R2, R3, L, L2, L3, U2, D2, F2, B2},
     {F, F2, F3, B, B2, B3, U2, D2, R2, L2}
 };
-
-  unordered_map<string, move_t> singmaster_map = {
-    {"U", U}, {"U2", U2}, {"U'", U3},
-    {"D", D}, {"D2", D2}, {"D'", D3},
-    {"R", R}, {"R2", R2}, {"R'", R3},
-    {"L", L}, {"L2", L2}, {"L'", L3},
-    {"F", F}, {"F2", F2}, {"F'", F3},
-    {"B", B}, {"B2", B2}, {"B'", B3}
-};
+/* Transformations that bring the R/L and F/B axes to U/D, as in drrl and drfb */
+const trans_t axistrans[3] = { UFr, FRr, FUr };
 
 void print_binary(uint8_t byte) {
     for(int i = 7; i >= 0; i--) {
@@ -38,6 +35,51 @@ cube_t apply_alg(cube_t cube, sol_t *moves) {
     return ret;
 }
 
+cube_t compile_alg(const sol_t &moves) {
+    cube_t ret = cube_new();
+    for (auto m : moves)
+        ret = cube_move(ret, m);
+    return ret;
+}
+
+cube_t AlgCache::get(const string &alg) {
+    {
+        lock_guard<mutex> guard(lock);
+        auto it = algs.find(alg);
+        if (it != algs.end())
+            return it->second;
+    }
+
+    sol_t moves(alg.size() + 1);
+    int n = cube_readmoves(alg.c_str(), moves.data());
+    if (n < 0) {
+        cube_t error;
+        memset(&error, 0, sizeof(error));
+        return error;
+    }
+    moves.resize(n);
+    cube_t c = compile_alg(moves);
+
+    lock_guard<mutex> guard(lock);
+    algs.emplace(alg, c);
+    return c;
+}
+
+cube_t AlgCache::apply(cube_t c, const string &alg) {
+    cube_t a = get(alg);
+    return cube_error(a) ? a : cube_compose(c, a);
+}
+
+size_t AlgCache::size() {
+    lock_guard<mutex> guard(lock);
+    return algs.size();
+}
+
+void AlgCache::clear() {
+    lock_guard<mutex> guard(lock);
+    algs.clear();
+}
+
 void print_solution_singmaster(sol_t s, bool l) {
     for (int i = 0; i < s.size(); i++) {
         switch(s[i]) {
@@ -65,6 +107,20 @@ void print_solution_singmaster(sol_t s, bool l) {
     printf("\n");
 }
 
+string solution_singmaster(const sol_t &s) {
+    static const char *names[] = {
+        "U", "U2", "U'", "D", "D2", "D'", "R", "R2", "R'",
+        "L", "L2", "L'", "F", "F2", "F'", "B", "B2", "B'"
+    };
+    string ret;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (i > 0)
+            ret += ' ';
+        ret += names[s[i]];
+    }
+    return ret;
+}
+
 void print_solution_enum(sol_t s) {
     for (int i = 0; i < s.size(); i++) {
         printf("%u ", s[i]);
@@ -72,78 +128,288 @@ void print_solution_enum(sol_t s) {
     printf("\n");
 }
 
+/*
+ * Orientation on all axes, from the piece bytes. An edge is oriented for
+ * FB when its eo bit is clear; for RL (or UD) the bit is flipped when
+ * exactly one of the piece and its position is in the E (or outside the M)
+ * slice. A corner is oriented for UD when its co bits are clear; for RL
+ * and FB its twist must be +1 or -1 when the piece comes from the other
+ * tetrad of corners (UFR UBL DFL DBR and UFL UBR DFR DBL).
+ *
+ * All the pieces are checked at once, 8 bytes at a time: each check leaves
+ * a nonzero bit in the byte of every piece that fails it.
+ */
+#define BYTES(x) (0x0101010101010101ULL * (x))
+
+int orientation(const cube_t c) {
+    const uint64_t lowcorners = 0x00000000FFFFFFFFULL;
+    const uint64_t notm = 0x1010101000000000ULL;  /* Edges 4 to 7 */
+    const uint64_t eslice = 0x10101010ULL;        /* Edges 8 to 11 */
+    uint64_t e1, e2 = 0, w, t, co, fb, rl, ud, cud, crl, cfb;
+
+    memcpy(&e1, c.edge, 8);
+    memcpy(&e2, c.edge + 8, 4);
+    /* Bits 2 and 3 of a piece are never both set, so xor works as or */
+    fb = (e1 | e2) & BYTES(0x10);
+    rl = ((e1 ^ (e1 << 1)) | (e2 ^ (e2 << 1) ^ eslice)) & BYTES(0x10);
+    ud = ((e1 ^ (e1 << 1) ^ (e1 << 2) ^ notm) |
+        (e2 ^ (e2 << 1) ^ (e2 << 2) ^ eslice)) & BYTES(0x10);
+
+    memcpy(&w, c.corner, 8);
+    t = (w & BYTES(0x04)) ^ (BYTES(0x04) & ~lowcorners);
+    co = w & BYTES(0x60);
+    cud = co;
+    crl = co ^ (((t << 4) & lowcorners) | ((t << 3) & ~lowcorners));
+    cfb = co ^ (((t << 3) & lowcorners) | ((t << 4) & ~lowcorners));
+
+    return (fb ? 0 : ORIENT_EOFB) | (rl ? 0 : ORIENT_EORL) |
+        (ud ? 0 : ORIENT_EOUD) | (cud ? 0 : ORIENT_COUD) |
+        (crl ? 0 : ORIENT_CORL) | (cfb ? 0 : ORIENT_COFB);
+}
+
 int eofb(const cube_t c) {
-    for (int i = 0; i < EDGES; i++) {
-        if (c.edge[i] & 0xF0) {
-            return false;
-        }
-    }
-    return true;
+    return (orientation(c) & ORIENT_EOFB) != 0;
 }
 
 int eorl(const cube_t c) {
-    cube_t transformed = cube_transform(c, URr);
-    return eofb(transformed);
+    return (orientation(c) & ORIENT_EORL) != 0;
 }
 
 int eoud(const cube_t c) {
-    cube_t transformed = cube_transform(c, FUr);
-    return eofb(transformed);
+    return (orientation(c) & ORIENT_EOUD) != 0;
 }
 
 int coud(const cube_t c) {
-    for (int i = 0; i < CORNERS; i++) {
-        if (c.corner[i] & 0xF0) {
-            return false;
-        }
-    }
-    return true;
+    return (orientation(c) & ORIENT_COUD) != 0;
 }
 
 int corl(const cube_t c) {
-    cube_t transformed = cube_transform(c, RUr);
-    return coud(transformed);
+    return (orientation(c) & ORIENT_CORL) != 0;
 }
 
 int cofb(const cube_t c) {
-    cube_t transformed = cube_transform(c, FUr);
-    return coud(transformed);
+    return (orientation(c) & ORIENT_COFB) != 0;
 }
 
 int drud(const cube_t c) {
-    return eofb(c) && eorl(c) && coud(c);
+    return (orientation(c) & ORIENT_DRUD) == ORIENT_DRUD;
 }
 
 int drrl(const cube_t c) {
-    return drud(cube_transform(c, RUr));
+    return (orientation(c) & ORIENT_DRRL) == ORIENT_DRRL;
 }
 
 int drfb(const cube_t c) {
-    return drud(cube_transform(c, FUr));
+    return (orientation(c) & ORIENT_DRFB) == ORIENT_DRFB;
 }
 
 int dr(const cube_t c) {
-    return drud(c) || drrl(c) || drfb(c);
+    int o = orientation(c);
+    return (o & ORIENT_DRUD) == ORIENT_DRUD ||
+        (o & ORIENT_DRRL) == ORIENT_DRRL ||
+        (o & ORIENT_DRFB) == ORIENT_DRFB;
+}
+
+/*
+ * Classes of the characters of a scramble file. Face letters are coded as
+ * the move on that face, modifiers as MODIFIER plus what they add to it, as
+ * in cube_readmoves(). Both accept the same lines, so batchsolve reads a file
+ * and the standard input in the same way.
+ */
+#define MODIFIER 0x20
+#define BLANK    0x40
+#define NEWLINE  0x80
+#define INVALID  0xC0
+
+static const uint8_t *scramble_codes() {
+    static uint8_t codes[256];
+    static bool init = [] {
+        memset(codes, INVALID, sizeof(codes));
+        codes['U'] = U; codes['D'] = D; codes['R'] = R;
+        codes['L'] = L; codes['F'] = F; codes['B'] = B;
+        codes['1'] = MODIFIER | 0; codes['2'] = MODIFIER | 1;
+        codes['3'] = MODIFIER | 2; codes['\''] = MODIFIER | 2;
+        codes[' '] = codes['\t'] = codes['\r'] = BLANK;
+        codes['\n'] = NEWLINE;
+        return true;
+    }();
+
+    (void)init;
+    return codes;
+}
+
+/* Maps the whole file, or gives NULL and len 0 for an empty one */
+static bool map_file(const string &filename, const char **map, size_t *len) {
+    struct stat st;
+
+    *map = NULL;
+    *len = 0;
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return true;
+    }
+    void *m = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (m == MAP_FAILED)
+        return false;
+
+    madvise(m, st.st_size, MADV_SEQUENTIAL);
+    *map = (const char *)m;
+    *len = st.st_size;
+    return true;
+}
+
+/*
+ * A move is a face letter, optionally followed by a modifier. Moves may be
+ * separated by blanks, but they do not need to be. The line from b to end,
+ * without its newline, is parsed into out, which must have room for one
+ * byte per character: every move takes at least one. Returns the number of
+ * moves, or -1 if the line is not a scramble.
+ * Each character is handled without branches: scrambles are random, and the
+ * branches on the kind of character would be mispredicted most of the time.
+ */
+static ptrdiff_t parse_scramble_line(const char *b, const char *end, uint8_t *out) {
+    const uint8_t *codes = scramble_codes();
+    uint8_t *start = out;
+    bool after_face = false, error = false;
+
+    for (; b < end; b++) {
+        uint8_t v = codes[(uint8_t)*b];
+        bool face = v < MODIFIER;
+        bool modifier = (v & ~3) == MODIFIER;
+        bool apply = modifier && after_face;
+        error |= v == INVALID || v == NEWLINE || (modifier && !after_face);
+        /*
+         * A modifier changes the last move, anything else writes past it,
+         * where only a face is kept. The byte is read only in the first
+         * case, the others are not initialized yet.
+         */
+        uint8_t *p = out - apply;
+        *p = apply ? *p + (v & 3) : v;
+        out += face;
+        after_face = face;
+    }
+
+    return error ? -1 : out - start;
+}
+
+/* The end of the line starting at b, and the start of the next one */
+static const char *line_end(const char *b, const char *end, const char **next) {
+    const char *nl = (const char *)memchr(b, '\n', end - b);
+    *next = nl == NULL ? end : nl + 1;
+    return nl == NULL ? end : nl;
+}
+
+bool ScrambleFile::open(const string &filename) {
+    const char *map;
+    size_t len;
+
+    buf.reset();
+    offsets.assign(1, 0);
+    bad.clear();
+
+    if (!map_file(filename, &map, &len))
+        return false;
+    if (len == 0)
+        return true;
+    parse(map, len);
+    munmap((void *)map, len);
+    return true;
+}
+
+/*
+ * The buffer is as large as the file, so it never needs to grow. It is not
+ * initialized, and the pages past the last move are never touched.
+ */
+void ScrambleFile::parse(const char *b, size_t len) {
+    const char *end = b + len, *next;
+
+    buf.reset(new uint8_t[len]);
+    uint8_t *start = buf.get(), *out = start;
+    for (; b < end; b = next) {
+        ptrdiff_t n = parse_scramble_line(b, line_end(b, end, &next), out);
+        if (n < 0)
+            bad.push_back(offsets.size());
+        out += max<ptrdiff_t>(n, 0);
+        offsets.push_back(out - start);
+    }
+}
+
+ScrambleStream::~ScrambleStream() {
+    if (map != NULL)
+        munmap((void *)map, len);
+}
+
+bool ScrambleStream::open(const string &filename) {
+    if (map != NULL)
+        munmap((void *)map, len);
+    if (!map_file(filename, &map, &len))
+        return false;
+    pos = released = map;
+    return true;
+}
+
+/*
+ * The pages already read are given back from time to time, so that the
+ * file does not stay in memory as a whole.
+ */
+bool ScrambleStream::next(sol_t &moves, bool &valid) {
+    const char *end = map + len, *next;
+
+    if (pos == end)
+        return false;
+    const char *eol = line_end(pos, end, &next);
+    if (line.size() < (size_t)(eol - pos))
+        line.resize(eol - pos);
+    ptrdiff_t n = parse_scramble_line(pos, eol, line.data());
+    valid = n >= 0;
+    moves.resize(max<ptrdiff_t>(n, 0));
+    for (size_t i = 0; i < moves.size(); i++)
+        moves[i] = (move_t)line[i];
+    pos = next;
+
+    if (pos - released >= RELEASE_BYTES) {
+        size_t page = sysconf(_SC_PAGESIZE);
+        const char *upto = map + (pos - map) / page * page;
+        madvise((void *)released, upto - released, MADV_DONTNEED);
+        released = upto;
+    }
+    return true;
+}
+
+bool ScrambleFile::valid(size_t i) const {
+    return !binary_search(bad.begin(), bad.end(), i + 1);
+}
+
+sol_t ScrambleFile::scramble(size_t i) const {
+    sol_t ret(length(i));
+    for (size_t j = 0; j < ret.size(); j++)
+        ret[j] = (move_t)moves(i)[j];
+    return ret;
 }
 
 sol_t read_scramble_from_file(const string& filename) {
-    ifstream file(filename);
-    string line;
+    ScrambleFile file;
     sol_t scramble;
-    
-    if (file.is_open()) {
-        while (getline(file, line)) {
-            istringstream iss(line);
-            string move_str;
-            while (iss >> move_str) {
-                scramble.push_back(singmaster_map[move_str]);
-            }
-        }
-        file.close();
-    } else {
+
+    if (!file.open(filename)) {
         cerr << "Unable to open file" << endl;
+        return scramble;
     }
-    
+    for (size_t line : file.errors())
+        cerr << "Line " << line << ": invalid scramble" << endl;
+    for (size_t i = 0; i < file.size(); i++) {
+        sol_t s = file.scramble(i);
+        scramble.insert(scramble.end(), s.begin(), s.end());
+    }
+
     return scramble;
 }
 
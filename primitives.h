@@ -2,6 +2,12 @@
 #define PRIMITIVES_H
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -14,24 +20,91 @@
 #define MOVES 18
 #define DRMOVES 10
 #define LIMSOL 20
+#define NAXES 3
+/* Previous move of the root node, it is not redundant with any move */
+#define NOMOVE ((move_t)MOVES)
+
+#define NTWIST 2187
+#define NFLIP 2048
+#define NSLICE 495
+#define NFLIPSLICE (NFLIP * NSLICE)
+#define NSYM 16
+#define NFSCLASS 64430
+#define NCP 40320
+#define NEPUD 40320
+#define NEPE 24
 
 using namespace std;
 typedef vector<move_t> sol_t;
 
+/* Phase 1 coordinates for each axis: corner twist, edge flip and E-slice */
+typedef struct {
+    uint16_t twist[NAXES];
+    uint16_t flip[NAXES];
+    uint16_t slice[NAXES];
+} p1coord_t;
+
+/* Phase 2 coordinates: corner, U/D edge and E-slice edge permutation */
+typedef struct {
+    uint16_t cp;
+    uint16_t epud;
+    uint16_t epe;
+} p2coord_t;
+
 
-extern unordered_map<string, move_t> singmaster_map;
 extern const sol_t moves;
 extern const move_t drmoves[3][10];
+extern const trans_t axistrans[3];
 
 
 cube_t apply_alg(cube_t cube, vector<move_t> *moves);
 
+/*
+ * An algorithm compiled to the cube it produces from the solved one, so that
+ * cube_compose(c, compile_alg(moves)) is the same as applying the moves to c.
+ */
+cube_t compile_alg(const sol_t &moves);
+
+/*
+ * Compiled algorithms, keyed by their move string. Strings that are not
+ * valid sequences of moves give the error cube (see cube_error()), both from
+ * get() and from apply(), and are not kept. The cache can be shared by many
+ * threads.
+ */
+class AlgCache {
+public:
+    cube_t get(const string &alg);
+    cube_t apply(cube_t c, const string &alg);
+    size_t size();
+    void clear();
+
+private:
+    mutex lock;
+    unordered_map<string, cube_t> algs;
+};
+
 void print_binary(uint8_t byte);
 void print_solution_H48(sol_t s);
 void print_solution_enum(sol_t s);
 void print_solution_singmaster(sol_t s, bool l=false);
+string solution_singmaster(const sol_t &s);
+
+
+/* Bits of orientation(): edges and corners oriented on each axis */
+#define ORIENT_EOFB 0x01
+#define ORIENT_EORL 0x02
+#define ORIENT_EOUD 0x04
+#define ORIENT_COUD 0x08
+#define ORIENT_CORL 0x10
+#define ORIENT_COFB 0x20
+#define ORIENT_ALL  0x3F
 
+/* Domino reduction on each axis */
+#define ORIENT_DRUD (ORIENT_COUD | ORIENT_EOFB | ORIENT_EORL)
+#define ORIENT_DRRL (ORIENT_CORL | ORIENT_EOFB | ORIENT_EOUD)
+#define ORIENT_DRFB (ORIENT_COFB | ORIENT_EORL | ORIENT_EOUD)
 
+int orientation(const cube_t c);
 int eofb(const cube_t c);
 int eorl(const cube_t c);
 int eoud(const cube_t c);
@@ -45,10 +118,172 @@ int drfb(const cube_t c);
 int dr(const cube_t c);
 
 bool notRedundantMove(move_t new_move, move_t last_move, move_t second_last_move);
+
+/*
+ * Scrambles read from a file, one per line. The file is mapped in memory and
+ * parsed in place, without copying lines or tokens: the moves of all lines
+ * are kept in a single buffer, one byte per move, and those of line i
+ * (counting from 0) are the length(i) bytes starting at moves(i). Lines that
+ * are not valid scrambles have no moves, and their numbers (counting from 1)
+ * are listed by errors().
+ */
+class ScrambleFile {
+public:
+    bool open(const string &filename);
+    size_t size() const { return offsets.size() - 1; }
+    const uint8_t *moves(size_t i) const { return buf.get() + offsets[i]; }
+    size_t length(size_t i) const { return offsets[i+1] - offsets[i]; }
+    bool valid(size_t i) const;
+    sol_t scramble(size_t i) const;
+    const vector<size_t> &errors() const { return bad; }
+
+private:
+    void parse(const char *b, size_t len);
+
+    unique_ptr<uint8_t[]> buf;
+    vector<size_t> offsets{0};
+    vector<size_t> bad;
+};
+
+/*
+ * The same scrambles read one line at a time, for files too large to parse
+ * at once. The file stays mapped and each call to next() parses the next
+ * line, so the memory used does not grow with the file. next() returns
+ * false at the end of the file, and sets valid to false for the lines that
+ * are not scrambles.
+ */
+class ScrambleStream {
+public:
+    ScrambleStream() {}
+    ScrambleStream(const ScrambleStream &) = delete;
+    ScrambleStream &operator=(const ScrambleStream &) = delete;
+    ~ScrambleStream();
+
+    bool open(const string &filename);
+    bool next(sol_t &moves, bool &valid);
+
+private:
+    static const ptrdiff_t RELEASE_BYTES = 64 << 20;
+
+    const char *map = NULL;
+    size_t len = 0;
+    const char *pos = NULL;
+    const char *released = NULL;
+    vector<uint8_t> line;
+};
+
+/* All the moves in the file, one line after the other */
 sol_t read_scramble_from_file(const string& filename);
 
-int phase2search(cube_t c, int d2, sol_t s, move_t last, move_t second_last, int td, int tdm, int ptdm);
-int phase1search(cube_t c, int d1, int d2, sol_t s, move_t last, move_t second_last, int td, int tdm, int ptdm);
-sol_t twoPhase(cube_t c);
+/* Tables that are saved to disk, in the directory $CUBE_TABLES or ./tables */
+typedef enum {
+    TABLE_PT_FS_TWIST,
+    TABLE_PT_CP_EPE,
+    TABLE_PT_EPUD_EPE,
+} table_kind_t;
+
+const uint8_t *load_table(table_kind_t kind, size_t size, void (*gen)(uint8_t *));
+
+void init_phase1_tables();
+p1coord_t phase1_coord(cube_t c);
+int phase1_bound(p1coord_t c, int *axis);
+void init_phase2_tables();
+p2coord_t phase2_coord(cube_t c, int axis);
+int phase2_bound(p2coord_t c);
+
+typedef enum {
+    SOLVE_DONE,         /* The search is over, the solution is the best found */
+    SOLVE_NO_SOLUTION,  /* The search is over and found no solution */
+    SOLVE_STOPPED,      /* The callback stopped the search */
+    SOLVE_NODE_LIMIT,
+    SOLVE_TIME_LIMIT,
+    SOLVE_UNSOLVABLE,
+} solve_status_t;
+
+/*
+ * The callback is called for each solution shorter than the ones found
+ * before, one call at a time, and returns false to stop the search. Zero
+ * limits mean no limit. The time limit starts when the tables are ready,
+ * so the first solve() can take longer if it has to load them.
+ */
+typedef struct {
+    int max_length = LIMSOL;
+    int64_t max_nodes = 0;
+    double max_time = 0;
+    int nthreads = 1;
+    function<bool(const sol_t &)> callback;
+} solve_options_t;
+
+/*
+ * Search statistics, only collected when the solver is compiled with
+ * -DSOLVE_STATS (otherwise they are all zero). Index 0 is phase 1 and
+ * index 1 is phase 2. Times are in seconds and summed over all threads.
+ */
+#ifdef SOLVE_STATS
+#define STATS(x) x
+#else
+#define STATS(x)
+#endif
+
+typedef struct {
+    int64_t nodes[2][LIMSOL+1];  /* Nodes by phase and by depth from the root */
+    int64_t cutoffs[2];          /* Nodes pruned by the heuristic */
+    int64_t lookups[2];          /* Pruning table lookups */
+    int64_t dr_leaves;           /* Phase 1 leaves that reach DR */
+    int64_t phase2_entries;      /* Phase 2 searches started from them */
+    double time[2];
+    double wall;
+} solve_stats_t;
+
+typedef struct {
+    solve_status_t status;
+    sol_t solution;
+    int64_t nodes;
+    solve_stats_t stats;
+} solve_result_t;
+
+/* State shared by all the threads that solve the same cube */
+typedef struct {
+    const solve_options_t *opts;
+    chrono::steady_clock::time_point deadline;
+    atomic<int> hb;
+    atomic<bool> stop;
+    atomic<int64_t> nodes;
+    mutex lock;
+    bool found;
+    sol_t best;
+    solve_status_t status;
+    solve_stats_t stats;
+} solve_shared_t;
+
+/*
+ * Search state of one thread: the cube, the depth limit and the stack of
+ * the moves from the root to the current node. No solution is longer than
+ * LIMSOL moves, so the search never allocates. Visited nodes are counted
+ * here and added to the shared count from time to time.
+ */
+typedef struct {
+    cube_t root;
+    solve_shared_t *sh;
+    int pd;
+    int64_t nodes;
+    move_t moves[LIMSOL];
+#ifdef SOLVE_STATS
+    solve_stats_t stats;
+#endif
+} search_t;
+
+void phase2search(search_t &st, p2coord_t c, int d2, move_t last, move_t second_last, int td, int axis);
+void phase1search(search_t &st, p1coord_t c, int d1, move_t last, move_t second_last, int td);
+
+solve_result_t solve(cube_t c, const solve_options_t &opts);
+void print_solve_stats(FILE *f, const solve_stats_t &stats);
+
+/*
+ * Returns the shortest solution found. With nthreads > 1, the phase 1 tree
+ * is split among a pool of threads. With verbose, every solution found is
+ * also printed.
+ */
+sol_t twoPhase(cube_t c, int nthreads = 1, bool verbose = true);
 
 #endif
@@ -0,0 +1,122 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "primitives.h"
+
+/*
+ * Table files start with a header that identifies the table and the
+ * version of the code that generated it. A file that does not match what
+ * the caller expects is ignored and the table is generated again, so
+ * bumping TABLE_VERSION invalidates all tables on disk. Valid files are
+ * mapped read-only and shared, so that processes using the same tables
+ * only keep one copy of them in the page cache.
+ */
+#define TABLE_MAGIC "CUBETBL"
+#define TABLE_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;
+    uint64_t size;
+    uint64_t checksum;
+} table_header_t;
+
+static const char *table_names[] = {
+    "pt_fs_twist",
+    "pt_cp_epe",
+    "pt_epud_epe",
+};
+
+static uint64_t checksum(const uint8_t *data, size_t size) {
+    uint64_t w, h = UINT64_C(0xcbf29ce484222325);
+    size_t i;
+
+    for (i = 0; i + 8 <= size; i += 8) {
+        memcpy(&w, data + i, 8);
+        h = (h ^ w) * UINT64_C(0x100000001b3);
+    }
+    for (; i < size; i++)
+        h = (h ^ data[i]) * UINT64_C(0x100000001b3);
+
+    return h;
+}
+
+static string table_path(table_kind_t kind) {
+    const char *dir = getenv("CUBE_TABLES");
+
+    return string(dir != NULL ? dir : "tables") + "/" + table_names[kind] + ".bin";
+}
+
+static const uint8_t *map_table(const string &path, table_kind_t kind, size_t size) {
+    struct stat st;
+    table_header_t h;
+    const uint8_t *data = NULL;
+    void *map;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+        return NULL;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size != sizeof(h) + size)
+        goto map_table_stale;
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+        goto map_table_stale;
+
+    memcpy(&h, map, sizeof(h));
+    data = (const uint8_t *)map + sizeof(h);
+    if (memcmp(h.magic, TABLE_MAGIC, sizeof(h.magic)) || h.version != TABLE_VERSION ||
+        h.kind != (uint32_t)kind || h.size != size || h.checksum != checksum(data, size)) {
+        munmap(map, st.st_size);
+        data = NULL;
+        goto map_table_stale;
+    }
+    close(fd);
+    return data;
+
+map_table_stale:
+    fprintf(stderr, "Table file %s is invalid, generating it again\n", path.c_str());
+    close(fd);
+    return NULL;
+}
+
+/* Write to a temporary file first, so that other processes never see a partial table */
+static void save_table(const string &path, table_kind_t kind, const uint8_t *data, size_t size) {
+    table_header_t h;
+    string tmp = path + ".tmp." + to_string(getpid());
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TABLE_MAGIC, sizeof(h.magic));
+    h.version = TABLE_VERSION;
+    h.kind = kind;
+    h.size = size;
+    h.checksum = checksum(data, size);
+
+    mkdir(path.substr(0, path.rfind('/')).c_str(), 0755);
+    FILE *f = fopen(tmp.c_str(), "wb");
+    if (f == NULL)
+        return;
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1 && fwrite(data, 1, size, f) == size;
+    ok = fclose(f) == 0 && ok;
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0)
+        remove(tmp.c_str());
+}
+
+const uint8_t *load_table(table_kind_t kind, size_t size, void (*gen)(uint8_t *)) {
+    string path = table_path(kind);
+    const uint8_t *data = map_table(path, kind, size);
+
+    if (data == NULL) {
+        uint8_t *table = new uint8_t[size];
+        gen(table);
+        save_table(path, kind, table, size);
+        data = table;
+    }
+
+    return data;
+}
@@ -0,0 +1,16 @@
+#include "../test.h"
+
+int main(void) {
+	const char *name;
+
+	name = cube_backend();
+
+	if (!strcmp(name, "portable") ||
+	    !strcmp(name, "swar") ||
+	    !strcmp(name, "avx2"))
+		printf("Backend is known\n");
+	else
+		printf("Unknown backend %s\n", name);
+
+	return 0;
+}
@@ -0,0 +1,55 @@
+#include <stdlib.h>
+#include <unistd.h>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include "../../primitives.h"
+
+/*
+ * The input is read as a file, with ScrambleFile and with ScrambleStream,
+ * and one line at a time with cube_readmoves(), as batchsolve does for the
+ * standard input. For each line the moves (or ERROR) are printed, and
+ * whether the three parsers agree.
+ */
+int main(void) {
+    string input((istreambuf_iterator<char>(cin)), istreambuf_iterator<char>());
+
+    char path[] = "/tmp/scramble_file_testXXXXXX";
+    int fd = mkstemp(path);
+    if (fd == -1 || write(fd, input.data(), input.size()) != (ssize_t)input.size()) {
+        printf("Cannot write %s\n", path);
+        return 1;
+    }
+    close(fd);
+    ScrambleFile file;
+    ScrambleStream stream;
+    bool opened = file.open(path) && stream.open(path);
+    unlink(path);
+    if (!opened) {
+        printf("Cannot open %s\n", path);
+        return 1;
+    }
+
+    istringstream lines(input);
+    string line;
+    size_t i;
+    for (i = 0; getline(lines, line); i++) {
+        sol_t moves(line.size() + 1);
+        int n = cube_readmoves(line.c_str(), moves.data());
+        moves.resize(max(n, 0));
+        sol_t streamed;
+        bool valid;
+        bool same = i < file.size() && file.valid(i) == (n >= 0) &&
+            file.scramble(i) == moves && stream.next(streamed, valid) &&
+            valid == (n >= 0) && streamed == moves;
+        printf("%zu: %s%s\n", i + 1,
+            n < 0 ? "ERROR" : solution_singmaster(moves).c_str(),
+            same ? "" : " (different)");
+    }
+    sol_t streamed;
+    bool valid;
+    if (i != file.size() || stream.next(streamed, valid))
+        printf("%zu lines, %zu in the file\n", i, file.size());
+
+    return 0;
+}
@@ -0,0 +1,23 @@
+#include "../test.h"
+
+#define NMAX 20
+
+int main(void) {
+	char format[STRLENMAX], buf[STRLENMAX], out[NMAX * 88 + 1];
+	cube_t cubes[NMAX];
+	cube_codec_error_t rerr[NMAX], werr[NMAX];
+	size_t i, n, len, used;
+
+	fgets(format, STRLENMAX, stdin);
+	format[strcspn(format, "\n")] = '\0';
+	len = fread(buf, 1, STRLENMAX, stdin);
+
+	n = cube_readbulk(format, buf, len, NMAX, cubes, rerr, &used);
+	printf("Read %zu cubes, %zu of %zu characters\n", n, used, len);
+	cube_writebulk(format, cubes, n, out, werr);
+	printf("%s", out);
+	for (i = 0; i < n; i++)
+		printf("%zu: read %d, write %d\n", i, rerr[i], werr[i]);
+
+	return 0;
+}
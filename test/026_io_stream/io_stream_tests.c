@@ -0,0 +1,144 @@
+#include "../test.h"
+
+#define NMAX     20
+#define BUFMAX   100000
+
+static uint8_t stream[BUFMAX];
+static size_t streamlen;
+
+static size_t
+writemem(const void *data, size_t len, void *arg)
+{
+	(void)arg;
+	if (streamlen + len > BUFMAX)
+		return 0;
+	memcpy(stream + streamlen, data, len);
+	streamlen += len;
+	return len;
+}
+
+static void
+printcube(cube_stream_reader_t *r, int64_t index)
+{
+	char buf[STRLENMAX];
+	move_t moves[CUBE_STREAM_MAXMOVES];
+	size_t i, n;
+	cube_t cube;
+
+	if (cube_stream_read(r, &cube, moves, &n) != 1) {
+		printf("%" PRId64 ": read error\n", index);
+		return;
+	}
+	cube_write("H48", cube, buf);
+	printf("%" PRId64 ": %s", index, buf);
+	for (i = 0; i < n; i++)
+		printf(" %s", cube_movestr(moves[i]));
+	printf("\n");
+}
+
+/*
+ * The first line has the flags and the block size, the second line the
+ * indices to seek to, the others a scramble each. The cube of each line is
+ * the solved cube with the scramble applied, and with CUBE_STREAM_MOVES the
+ * scramble is attached to it. Lines that are not scrambles give an
+ * inconsistent cube, which is not written.
+ *
+ * If the first line is "raw" instead, the third line is a stream given as
+ * hexadecimal bytes, which is read as it is.
+ */
+static void
+readraw(int *seek, int nseek)
+{
+	char line[STRLENMAX], *p;
+	unsigned x;
+	int i, ret;
+	cube_t cube;
+	cube_stream_reader_t r;
+
+	fgets(line, STRLENMAX, stdin);
+	for (streamlen = 0, p = strtok(line, " \n"); p != NULL &&
+	    streamlen < BUFMAX; p = strtok(NULL, " \n")) {
+		sscanf(p, "%x", &x);
+		stream[streamlen++] = x;
+	}
+
+	if (cube_stream_reader_init(&r, stream, streamlen) != 0) {
+		printf("Cannot read stream\n");
+		return;
+	}
+	for (i = 0; i < nseek; i++) {
+		if (cube_stream_seek(&r, seek[i]) != 0) {
+			printf("%d: seek error\n", seek[i]);
+			continue;
+		}
+		ret = cube_stream_read(&r, &cube, NULL, NULL);
+		printf("%d: read %d\n", seek[i], ret);
+	}
+}
+
+int main(void) {
+	char line[STRLENMAX], *p;
+	uint8_t buf[CUBE_STREAM_BUFSIZE(NMAX, CUBE_STREAM_MOVES)];
+	move_t moves[STRLENMAX];
+	bool raw;
+	int i, flags, blocksize, n, ret, seek[NMAX], nseek;
+	int64_t k;
+	cube_t cube;
+	cube_stream_writer_t w;
+	cube_stream_reader_t r;
+
+	fgets(line, STRLENMAX, stdin);
+	raw = strncmp(line, "raw", 3) == 0;
+	sscanf(line, "%d %d", &flags, &blocksize);
+	fgets(line, STRLENMAX, stdin);
+	for (nseek = 0, p = strtok(line, " \n"); p != NULL && nseek < NMAX;
+	    p = strtok(NULL, " \n"))
+		seek[nseek++] = atoi(p);
+	if (raw) {
+		readraw(seek, nseek);
+		return 0;
+	}
+
+	if (cube_stream_writer_init(&w, flags, blocksize, buf, writemem,
+	    NULL) != 0) {
+		printf("Cannot write stream\n");
+		return 0;
+	}
+	while (fgets(line, STRLENMAX, stdin) != NULL) {
+		n = cube_readmoves(line, moves);
+		for (i = 0, cube = cube_new(); i < n; i++)
+			cube = cube_move(cube, moves[i]);
+		if (n < 0)
+			memset(&cube, 0, sizeof(cube));
+		ret = cube_stream_write(&w, cube, moves, n < 0 ? 0 : n);
+		printf("write %d\n", ret);
+	}
+	ret = cube_stream_writer_close(&w);
+	printf("close %d, %" PRIu64 " cubes, %zu bytes\n",
+	    ret, w.count, streamlen);
+
+	if (cube_stream_reader_init(&r, stream, streamlen) != 0) {
+		printf("Cannot read stream\n");
+		return 0;
+	}
+	for (k = 0; k < (int64_t)w.count; k++)
+		printcube(&r, k);
+	printf("end %d\n", cube_stream_read(&r, &cube, moves, NULL));
+
+	for (i = 0; i < nseek; i++) {
+		if (cube_stream_seek(&r, seek[i]) != 0)
+			printf("%d: seek error\n", seek[i]);
+		else if (seek[i] == (int)w.count)
+			printf("%d: end %d\n", seek[i],
+			    cube_stream_read(&r, &cube, NULL, NULL));
+		else
+			printcube(&r, seek[i]);
+	}
+
+	/* Without the last block the stream is truncated */
+	cube_stream_reader_init(&r, stream, streamlen - 8);
+	for (k = 0; (ret = cube_stream_read(&r, &cube, NULL, NULL)) == 1; k++) ;
+	printf("truncated: %" PRId64 " cubes, then %d\n", k, ret);
+
+	return 0;
+}
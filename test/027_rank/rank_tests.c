@@ -0,0 +1,45 @@
+#include "../test.h"
+
+/*
+ * Each line is either a cube in H48 format, which is ranked, or "rank"
+ * followed by the two halves of a rank in hexadecimal, which is unranked.
+ * In both cases the result is converted back and compared.
+ */
+int main(void) {
+	char line[STRLENMAX], buf[STRLENMAX];
+	uint8_t bytes[CUBE_RANK_BYTES];
+	int i;
+	uint64_t hi, lo;
+	cube_t cube, back;
+	cube_rank_t r, q;
+
+	while (fgets(line, STRLENMAX, stdin) != NULL) {
+		if (sscanf(line, "rank %" SCNx64 " %" SCNx64, &hi, &lo) == 2) {
+			r.hi = hi;
+			r.lo = lo;
+			cube = cube_unrank(r);
+			if (cube_error(cube)) {
+				printf("error\n");
+				continue;
+			}
+			cube_write("H48", cube, buf);
+			q = cube_rank(cube);
+			printf("%s\nsolvable: %d, same rank: %d\n", buf,
+			    cube_solvable(cube), q.hi == r.hi && q.lo == r.lo);
+		} else {
+			cube = cube_read("H48", line);
+			r = cube_rank(cube);
+			back = cube_unrank(r);
+			cube_rank_write(r, bytes);
+			q = cube_rank_read(bytes);
+			printf("%" PRIx64 " %016" PRIx64 " ", r.hi, r.lo);
+			for (i = 0; i < CUBE_RANK_BYTES; i++)
+				printf("%02x", bytes[i]);
+			printf("\nsame cube: %d, same rank: %d\n",
+			    cube_equal(cube, back),
+			    q.hi == r.hi && q.lo == r.lo);
+		}
+	}
+
+	return 0;
+}
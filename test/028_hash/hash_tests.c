@@ -0,0 +1,20 @@
+#include "../test.h"
+
+/*
+ * Each pair of lines is two cubes in H48 format. The hash itself depends on
+ * the byte order, so only its agreement with cube_equal() is printed.
+ */
+int main(void) {
+	char line1[STRLENMAX], line2[STRLENMAX];
+	cube_t c1, c2;
+
+	while (fgets(line1, STRLENMAX, stdin) != NULL &&
+	    fgets(line2, STRLENMAX, stdin) != NULL) {
+		c1 = cube_read("H48", line1);
+		c2 = cube_read("H48", line2);
+		printf("equal: %d, same hash: %d\n", cube_equal(c1, c2),
+		    cube_hash(c1) == cube_hash(c2));
+	}
+
+	return 0;
+}
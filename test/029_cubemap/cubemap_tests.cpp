@@ -0,0 +1,131 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../../cubemap.h"
+
+using namespace std;
+
+/* Different cubes, spread over the whole range of ranks */
+static cube_t nth_cube(uint64_t i) {
+    cube_rank_t r = { 0, i * UINT64_C(1000003) };
+    return cube_unrank(r);
+}
+
+/*
+ * Inserts n cubes one at a time, growing the table from its minimal size,
+ * and looks them up again.
+ */
+static void basic(size_t n) {
+    CubeMap<uint64_t> map;
+    size_t initial = map.capacity(), added = 0, found = 0, wrong = 0;
+
+    for (uint64_t i = 0; i < n; i++)
+        added += map.insert(nth_cube(i), i).second;
+    for (uint64_t i = 0; i < n; i++)
+        added += map.insert(nth_cube(i), 0).second;
+    printf("size %zu, added %zu, grown %d\n", map.size(), added,
+        map.capacity() > initial);
+
+    for (uint64_t i = 0; i < n; i++) {
+        uint64_t *v = map.find(nth_cube(i));
+        found += v != NULL;
+        wrong += v != NULL && *v != i;
+    }
+    printf("found %zu, wrong values %zu, missing found %d\n", found, wrong,
+        map.contains(nth_cube(n)) || map.find(nth_cube(n + 1)) != NULL);
+
+    map[nth_cube(0)] += 10;
+    map[nth_cube(n)] += 5;
+    printf("operator[]: %" PRIu64 " %" PRIu64 ", size %zu\n",
+        map[nth_cube(0)], map[nth_cube(n)], map.size());
+
+    uint64_t sum = 0;
+    size_t visited = 0;
+    map.for_each([&](cube_t c, uint64_t v) {
+        sum += v;
+        visited += map.find(c) != NULL;
+    });
+    printf("for_each: %zu cubes, sum %" PRIu64 "\n", visited, sum);
+
+    CubeSet set;
+    for (uint64_t i = 0; i < n; i++)
+        set.insert(nth_cube(i % (n / 2 + 1)));
+    size_t inset = 0;
+    set.for_each([&](cube_t c) { inset += set.contains(c); });
+    printf("set: size %zu, for_each %zu\n", set.size(), inset);
+
+    map.clear();
+    printf("clear: size %zu, found %d\n", map.size(),
+        map.contains(nth_cube(0)));
+}
+
+/* Each thread inserts all the n cubes, so that most inserts are duplicates */
+static void concurrent(size_t n, int nthreads) {
+    CubeMap<uint64_t> map;
+    atomic<size_t> added{0}, present{0}, full{0};
+    vector<thread> threads;
+
+    map.reserve(n);
+    for (int t = 0; t < nthreads; t++)
+        threads.push_back(thread([&, t] {
+            for (uint64_t k = 0; k < n; k++) {
+                uint64_t i = (k + t * n / nthreads) % n;
+                int r = map.insert_concurrent(nth_cube(i), i);
+                added += r == 1;
+                present += r == 0;
+                full += r == -1;
+                if (map.find(nth_cube(i)) == NULL)
+                    full += 1000000;
+            }
+        }));
+    for (auto &t : threads)
+        t.join();
+
+    size_t wrong = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        uint64_t *v = map.find(nth_cube(i));
+        wrong += v == NULL || *v != i;
+    }
+    printf("size %zu, added %zu, present %zu, full %zu, wrong %zu\n",
+        map.size(), added.load(), present.load(), full.load(), wrong);
+}
+
+/* insert_concurrent() never grows the table */
+static void fill(size_t n) {
+    CubeMap<bool> map;
+    size_t added = 0, full = 0;
+
+    for (uint64_t i = 0; i < n; i++) {
+        int r = map.insert_concurrent(nth_cube(i), true);
+        added += r == 1;
+        full += r == -1;
+    }
+    printf("capacity %zu, size %zu, added %zu, full %zu\n",
+        map.capacity(), map.size(), added, full);
+
+    map.insert(nth_cube(n), true);
+    printf("insert grows: %d\n", map.capacity() > added);
+}
+
+/*
+ * The input is one of "basic n", "concurrent n threads" and "full n".
+ */
+int main(void) {
+    char mode[100];
+    size_t n;
+    int nthreads = 1;
+
+    if (scanf("%99s %zu %d", mode, &n, &nthreads) < 2)
+        return 1;
+    if (!strcmp(mode, "basic"))
+        basic(n);
+    else if (!strcmp(mode, "concurrent"))
+        concurrent(n, nthreads);
+    else if (!strcmp(mode, "full"))
+        fill(n);
+
+    return 0;
+}
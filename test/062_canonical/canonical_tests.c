@@ -0,0 +1,44 @@
+#include "../test.h"
+
+/*
+ * The first line is "normal" or "inverse", the second is a cube in H48
+ * format. Besides the canonical cube, the test checks that no transformation
+ * gives a smaller cube and that all the transformations of the cube (and of
+ * its inverse) have the same canonical cube.
+ */
+int main(void) {
+	char mode[STRLENMAX], cubestr[STRLENMAX];
+	bool inverse, inverted, minimal, invariant;
+	int i, k;
+	cube_t cube, canon, c, x;
+	trans_t t;
+
+	fgets(mode, STRLENMAX, stdin);
+	fgets(cubestr, STRLENMAX, stdin);
+	inverse = strncmp(mode, "inverse", 7) == 0;
+	cube = cube_read("H48", cubestr);
+
+	canon = cube_canonical(cube, inverse, &t, &inverted);
+	c = inverted ? cube_inverse(cube) : cube;
+	cube_write("H48", canon, cubestr);
+	printf("%s\n", cubestr);
+	printf("%s%s\n", cube_transstr(t), inverted ? ", inverse" : "");
+	printf("reached: %d\n", cube_equal(cube_transform(c, t), canon));
+
+	minimal = invariant = true;
+	for (k = 0; k < (inverse ? 2 : 1); k++) {
+		c = k == 0 ? cube : cube_inverse(cube);
+		for (i = 0; i < 48; i++) {
+			x = cube_transform(c, (trans_t)i);
+			if (memcmp(&x, &canon, sizeof(cube_t)) < 0)
+				minimal = false;
+			if (!cube_equal(cube_canonical(x, inverse, NULL, NULL),
+			    canon))
+				invariant = false;
+		}
+	}
+	printf("minimal: %d\n", minimal);
+	printf("invariant: %d\n", invariant);
+
+	return 0;
+}
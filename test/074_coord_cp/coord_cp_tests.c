@@ -0,0 +1,16 @@
+#include "../test.h"
+
+int main(void) {
+	char str[STRLENMAX];
+	cube_t cube;
+	int64_t result;
+
+	fgets(str, STRLENMAX, stdin);
+	cube = cube_read("H48", str);
+
+	result = cube_coord_cp(cube);
+
+	printf("%" PRId64 "\n", result);
+
+	return 0;
+}
@@ -0,0 +1,49 @@
+#include "../test.h"
+
+struct {
+	char *name;
+	cube_t (*invcoord)(int64_t);
+	int64_t (*coord)(cube_t);
+} coords[] = {
+	{ "co", cube_invcoord_co, cube_coord_co },
+	{ "eo", cube_invcoord_eo, cube_coord_eo },
+	{ "eslice", cube_invcoord_eslice, cube_coord_eslice },
+	{ "cp", cube_invcoord_cp, cube_coord_cp },
+	{ "epud", cube_invcoord_epud, cube_coord_epud },
+	{ "epe", cube_invcoord_epe, cube_coord_epe },
+	{ "ep", cube_invcoord_ep, cube_coord_ep },
+	{ "csep", cube_invcoord_csep, cube_coord_csep },
+	{ "esep", cube_invcoord_esep, cube_coord_esep },
+	{ NULL, NULL, NULL }
+};
+
+int main(void) {
+	char name[STRLENMAX], str[STRLENMAX];
+	int i;
+	int64_t coord;
+	cube_t cube;
+
+	fgets(name, STRLENMAX, stdin);
+	name[strcspn(name, "\n")] = 0;
+	fgets(str, STRLENMAX, stdin);
+	coord = atoll(str);
+
+	for (i = 0; coords[i].name != NULL; i++)
+		if (!strcmp(name, coords[i].name))
+			break;
+	if (coords[i].name == NULL) {
+		printf("Unknown coordinate %s\n", name);
+		return 1;
+	}
+
+	cube = coords[i].invcoord(coord);
+	if (!cube_solvable(cube)) {
+		printf("Cube is not solvable\n");
+	} else {
+		cube_write("H48", cube, str);
+		printf("%s\n", str);
+		printf("%" PRId64 "\n", coords[i].coord(cube));
+	}
+
+	return 0;
+}
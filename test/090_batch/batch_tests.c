@@ -0,0 +1,56 @@
+#include "../test.h"
+
+#define NMAX 64
+
+int main(void) {
+	char kind[STRLENMAX], opstr[STRLENMAX], cubestr[STRLENMAX];
+	uint8_t buf[20*NMAX], bufout[20*NMAX];
+	size_t i, n;
+	move_t moves[STRLENMAX];
+	trans_t t;
+	cube_t cube[NMAX], single[NMAX], batch[NMAX], soa[NMAX];
+	cube_soa_t soain, soaout;
+
+	fgets(kind, STRLENMAX, stdin);
+	fgets(opstr, STRLENMAX, stdin);
+	for (n = 0; n < NMAX && fgets(cubestr, STRLENMAX, stdin); n++)
+		cube[n] = cube_read("H48", cubestr);
+
+	cube_soa_init(&soain, n, buf);
+	cube_soa_init(&soaout, n, bufout);
+	cube_soa_load(&soain, cube);
+
+	if (kind[0] == 'm') {
+		cube_readmoves(opstr, moves);
+		for (i = 0; i < n; i++)
+			single[i] = cube_move(cube[i], moves[0]);
+		cube_move_batch(cube, moves[0], n, batch);
+		cube_soa_move(&soain, moves[0], &soaout);
+	} else if (kind[0] == 't') {
+		t = cube_readtrans(opstr);
+		for (i = 0; i < n; i++)
+			single[i] = cube_transform(cube[i], t);
+		cube_transform_batch(cube, t, n, batch);
+		cube_soa_transform(&soain, t, &soaout);
+	} else {
+		for (i = 0; i < n; i++)
+			single[i] = cube_compose(cube[i], cube[(i+1)%n]);
+		for (i = 0; i < n; i++)
+			soa[i] = cube[(i+1)%n];
+		cube_compose_batch(cube, soa, n, batch);
+		/* Only check that load and store round-trip */
+		cube_soa_load(&soaout, batch);
+	}
+	cube_soa_store(&soaout, soa);
+
+	for (i = 0; i < n; i++) {
+		if (!cube_equal(single[i], batch[i]))
+			printf("Batch result %zu differs\n", i);
+		if (!cube_equal(single[i], soa[i]))
+			printf("SoA result %zu differs\n", i);
+		cube_write("H48", batch[i], cubestr);
+		printf("%s\n", cubestr);
+	}
+
+	return 0;
+}
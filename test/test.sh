@@ -5,21 +5,33 @@ detectsan() { cc -fsanitize=$1 -dM -E -x c - </dev/null | grep "SANITIZE"; }
 re="${TEST:-$@}"
 
 CC="cc -DDEBUG -std=c99 -pedantic -Wall -Wextra -g3"
+CXX="c++ -std=c++11 -pthread -g3"
 
-[ -n "$(detectsan address)" ] && CC="$CC -fsanitize=address"
-[ -n "$(detectsan undefined)" ] && CC="$CC -fsanitize=undefined"
+[ -n "$(detectsan address)" ] && CC="$CC -fsanitize=address" && \
+    CXX="$CXX -fsanitize=address"
+[ -n "$(detectsan undefined)" ] && CC="$CC -fsanitize=undefined" && \
+    CXX="$CXX -fsanitize=undefined"
 
 TESTBIN="test/run"
 TESTOUT="test/last.out"
 TESTERR="test/last.err"
 CUBEOBJ="debugcube.o"
 
+echo "Testing with CUBETYPE=${CUBETYPE:-CUBE_PORTABLE}"
+
 for t in test/*; do
 	if [ -n "$re" ] && [ -z "$(echo "$t" | grep "$re")" ]; then
 		continue
 	fi
 	if [ ! -d $t ]; then continue; fi
-	$CC -o $TESTBIN $t/*.c $CUBEOBJ || exit 1;
+	# Tests of the C++ code are linked with primitives.cpp too
+	if [ -n "$(ls $t/*.c 2>/dev/null)" ]; then
+		$CC -o $TESTBIN $t/*.c $CUBEOBJ || exit 1;
+	elif [ -n "$(ls $t/*.cpp 2>/dev/null)" ]; then
+		$CXX -o $TESTBIN $t/*.cpp primitives.cpp $CUBEOBJ || exit 1;
+	else
+		continue
+	fi
 	for cin in $t/*.in; do
 		c=$(echo "$cin" | sed 's/\.in//')
 		cout=$c.out
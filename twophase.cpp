@@ -1,63 +1,632 @@
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include "primitives.h"
 
-int phase2search(cube_t c, int d2, sol_t s, move_t last, move_t second_last, int td, int hb, int axis, int pd) {
-    if (d2 == 0) {
-        if (cube_solved(c)) {
-            print_solution_singmaster(s, true);
-            hb = min(hb, td);
-            return hb;
+/*
+ * The search only works on coordinates, which are updated by move tables
+ * indexed by coordinate and move. Phase 1 keeps the corner twist, edge
+ * flip and E-slice coordinates for each of the three axes: the coordinates
+ * for axis a are those of the cube transformed by axistrans[a], and the
+ * move m becomes moveconj[a][m] in this frame. Phase 2 works in the U/D
+ * frame in the same way, with its moves mapped by drconj.
+ *
+ * The pruning tables give the number of moves needed to bring a set of
+ * coordinates to 0. Phase 2 pairs the corner and U/D edge permutations
+ * with the E-slice permutation. Phase 1 uses all three of its coordinates,
+ * which gives the exact distance from DR, but reduces them by the 16
+ * symmetries that fix the U/D axis: a flip and slice pair is replaced by
+ * its symmetry class and the symmetry s that brings it to the class
+ * representative, and the twist is conjugated by s to match.
+ */
+static uint16_t mt_twist[NTWIST][MOVES];
+static uint16_t mt_flip[NFLIP][MOVES];
+static uint16_t mt_slice[NSLICE][MOVES];
+static int moveconj[NAXES][MOVES];
+
+static const trans_t udsym[NSYM] = {
+    UFr, ULr, UBr, URr, DFr, DLr, DBr, DRr,
+    UFm, ULm, UBm, URm, DFm, DLm, DBm, DRm
+};
+static uint16_t twist_conj[NTWIST][NSYM];
+static uint16_t fs_class[NFLIPSLICE];
+static uint8_t fs_sym[NFLIPSLICE];
+static uint32_t fs_rep[NFSCLASS];
+static uint16_t fs_stab[NFSCLASS];
+
+/* 4 bits per entry, indexed by class * NTWIST + conjugated twist */
+#define PT_FS_TWIST_SIZE (((size_t)NFSCLASS * NTWIST + 1) / 2)
+static const uint8_t *pt_fs_twist;
+static once_flag phase1_once;
+
+static uint16_t mt_cp[NCP][DRMOVES];
+static uint16_t mt_epud[NEPUD][DRMOVES];
+static uint16_t mt_epe[NEPE][DRMOVES];
+static const uint8_t *pt_cp_epe;
+static const uint8_t *pt_epud_epe;
+static int drconj[NAXES][DRMOVES];
+static once_flag phase2_once;
+
+static void gen_movetable(uint16_t *table, size_t n, int64_t (*coord)(cube_t), cube_t (*invcoord)(int64_t), const move_t *mv, int nm) {
+    for (size_t x = 0; x < n; x++) {
+        cube_t c = invcoord(x);
+        for (int m = 0; m < nm; m++)
+            table[x * nm + m] = coord(cube_move(c, mv[m]));
+    }
+}
+
+/* Breadth-first search over pairs of coordinates, indexed by a * nb + b */
+static void gen_pruning(uint8_t *table, const uint16_t *mta, size_t na, const uint16_t *mtb, size_t nb, int nm) {
+    vector<uint32_t> frontier(1, 0), next;
+
+    memset(table, 0xFF, na * nb);
+    table[0] = 0;
+    for (uint8_t d = 0; !frontier.empty(); d++) {
+        next.clear();
+        for (auto i : frontier) {
+            uint32_t a = i / nb, b = i % nb;
+            for (int m = 0; m < nm; m++) {
+                uint32_t j = mta[a * nm + m] * nb + mtb[b * nm + m];
+                if (table[j] == 0xFF) {
+                    table[j] = d + 1;
+                    next.push_back(j);
+                }
+            }
         }
-        return INT_MAX;
-    } else if (d2 > 0 && td <= pd) {
+        frontier.swap(next);
+    }
+}
+
+/* The index j of the move in mv such that transforming m by t gives mv[j] */
+static int conjugate(move_t m, trans_t t, const move_t *mv, int nm) {
+    cube_t c = cube_transform(cube_move(cube_new(), m), t);
+    for (int j = 0; j < nm; j++)
+        if (cube_equal(c, cube_move(cube_new(), mv[j])))
+            return j;
+    return -1;
+}
+
+static inline int pt_get(const uint8_t *table, size_t i) {
+    return (table[i >> 1] >> ((i & 1) << 2)) & 0xF;
+}
+
+static inline void pt_set(uint8_t *table, size_t i, int v) {
+    table[i >> 1] = (table[i >> 1] & ~(0xF << ((i & 1) << 2))) | (v << ((i & 1) << 2));
+}
+
+static cube_t flipslice_cube(uint32_t fs) {
+    cube_t c = cube_invcoord_eslice(fs % NSLICE);
+    cube_t e = cube_invcoord_eo(fs / NSLICE);
+
+    for (int i = 0; i < EDGES; i++)
+        c.edge[i] = (c.edge[i] & 0x0F) | (e.edge[i] & 0x10);
+
+    return c;
+}
+
+static uint32_t flipslice(cube_t c) {
+    return cube_coord_eo(c) * NSLICE + cube_coord_eslice(c);
+}
+
+static void gen_symmetries() {
+    int inv[NSYM];
+
+    for (int k = 0; k < NSYM; k++)
+        for (int j = 0; j < NSYM; j++)
+            if (udsym[j] == cube_inversetrans(udsym[k]))
+                inv[k] = j;
+
+    for (int x = 0; x < NTWIST; x++) {
+        cube_t c = cube_invcoord_co(x);
+        for (int k = 0; k < NSYM; k++)
+            twist_conj[x][k] = cube_coord_co(cube_transform(c, udsym[k]));
+    }
+
+    /* The representative of each class is its smallest coordinate */
+    uint16_t n = 0;
+    memset(fs_class, 0xFF, sizeof(fs_class));
+    for (uint32_t fs = 0; fs < NFLIPSLICE; fs++) {
+        if (fs_class[fs] != 0xFFFF)
+            continue;
+        cube_t c = flipslice_cube(fs);
+        fs_rep[n] = fs;
+        fs_stab[n] = 0;
+        for (int k = 0; k < NSYM; k++) {
+            uint32_t y = flipslice(cube_transform(c, udsym[k]));
+            if (y == fs)
+                fs_stab[n] |= 1 << k;
+            if (fs_class[y] == 0xFFFF) {
+                fs_class[y] = n;
+                fs_sym[y] = inv[k];
+            }
+        }
+        n++;
+    }
+}
+
+static inline size_t fs_twist_index(int flip, int slice, int twist) {
+    uint32_t fs = flip * NSLICE + slice;
+    return (size_t)fs_class[fs] * NTWIST + twist_conj[twist][fs_sym[fs]];
+}
+
+/*
+ * Breadth-first search by layers. When more than half of the table is
+ * filled it is faster to look for the missing entries that have a
+ * neighbor at the current depth. A new entry whose class representative
+ * is fixed by some symmetry also fills the entries of the same position
+ * seen through that symmetry.
+ */
+static void gen_pruning_sym(uint8_t *table) {
+    const size_t n = (size_t)NFSCLASS * NTWIST;
+    size_t done = 1;
+
+    memset(table, 0xFF, PT_FS_TWIST_SIZE);
+    pt_set(table, 0, 0);
+    for (int d = 0; done < n; d++) {
+        bool backward = done > n / 2;
+        for (size_t i = 0; i < n; i++) {
+            int v = pt_get(table, i);
+            if (backward ? v != 0xF : v != d)
+                continue;
+            uint32_t cls = i / NTWIST, fs = fs_rep[cls];
+            int flip = fs / NSLICE, slice = fs % NSLICE, twist = i % NTWIST;
+            for (int m = 0; m < MOVES; m++) {
+                size_t j = fs_twist_index(mt_flip[flip][m], mt_slice[slice][m], mt_twist[twist][m]);
+                if (backward) {
+                    if (pt_get(table, j) == d) {
+                        pt_set(table, i, d + 1);
+                        done++;
+                        break;
+                    }
+                    continue;
+                }
+                if (pt_get(table, j) != 0xF)
+                    continue;
+                pt_set(table, j, d + 1);
+                done++;
+                uint32_t cj = j / NTWIST;
+                for (int k = 1; k < NSYM; k++) {
+                    if (!(fs_stab[cj] & (1 << k)))
+                        continue;
+                    size_t jk = cj * NTWIST + twist_conj[j % NTWIST][k];
+                    if (pt_get(table, jk) == 0xF) {
+                        pt_set(table, jk, d + 1);
+                        done++;
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void gen_phase1_tables() {
+    gen_movetable(mt_twist[0], NTWIST, cube_coord_co, cube_invcoord_co, moves.data(), MOVES);
+    gen_movetable(mt_flip[0], NFLIP, cube_coord_eo, cube_invcoord_eo, moves.data(), MOVES);
+    gen_movetable(mt_slice[0], NSLICE, cube_coord_eslice, cube_invcoord_eslice, moves.data(), MOVES);
+    gen_symmetries();
+    pt_fs_twist = load_table(TABLE_PT_FS_TWIST, PT_FS_TWIST_SIZE, gen_pruning_sym);
+    for (int a = 0; a < NAXES; a++)
+        for (int m = 0; m < MOVES; m++)
+            moveconj[a][m] = conjugate(moves[m], axistrans[a], moves.data(), MOVES);
+}
+
+/* Threads that call it together wait for the first one to build the tables */
+void init_phase1_tables() {
+    call_once(phase1_once, gen_phase1_tables);
+}
+
+p1coord_t phase1_coord(cube_t c) {
+    p1coord_t ret;
+
+    for (int a = 0; a < NAXES; a++) {
+        cube_t t = cube_transform(c, axistrans[a]);
+        ret.twist[a] = cube_coord_co(t);
+        ret.flip[a] = cube_coord_eo(t);
+        ret.slice[a] = cube_coord_eslice(t);
+    }
+
+    return ret;
+}
+
+static inline p1coord_t phase1_move(p1coord_t c, int m) {
+    p1coord_t ret;
+
+    for (int a = 0; a < NAXES; a++) {
+        int ma = moveconj[a][m];
+        ret.twist[a] = mt_twist[c.twist[a]][ma];
+        ret.flip[a] = mt_flip[c.flip[a]][ma];
+        ret.slice[a] = mt_slice[c.slice[a]][ma];
+    }
+
+    return ret;
+}
+
+int phase1_bound(p1coord_t c, int *axis) {
+    int best = INT_MAX;
+    for (int a = 0; a < NAXES; a++) {
+        int h = pt_get(pt_fs_twist, fs_twist_index(c.flip[a], c.slice[a], c.twist[a]));
+        if (h < best) {
+            best = h;
+            *axis = a;
+        }
+    }
+    return best;
+}
+
+static void gen_phase2_tables() {
+    gen_movetable(mt_cp[0], NCP, cube_coord_cp, cube_invcoord_cp, drmoves[0], DRMOVES);
+    gen_movetable(mt_epud[0], NEPUD, cube_coord_epud, cube_invcoord_epud, drmoves[0], DRMOVES);
+    gen_movetable(mt_epe[0], NEPE, cube_coord_epe, cube_invcoord_epe, drmoves[0], DRMOVES);
+    pt_cp_epe = load_table(TABLE_PT_CP_EPE, NCP * NEPE, [](uint8_t *t) {
+        gen_pruning(t, mt_cp[0], NCP, mt_epe[0], NEPE, DRMOVES);
+    });
+    pt_epud_epe = load_table(TABLE_PT_EPUD_EPE, NEPUD * NEPE, [](uint8_t *t) {
+        gen_pruning(t, mt_epud[0], NEPUD, mt_epe[0], NEPE, DRMOVES);
+    });
+    for (int a = 0; a < NAXES; a++)
+        for (int i = 0; i < DRMOVES; i++)
+            drconj[a][i] = conjugate(drmoves[a][i], axistrans[a], drmoves[0], DRMOVES);
+}
+
+void init_phase2_tables() {
+    call_once(phase2_once, gen_phase2_tables);
+}
+
+p2coord_t phase2_coord(cube_t c, int axis) {
+    cube_t t = cube_transform(c, axistrans[axis]);
+    p2coord_t ret;
+
+    ret.cp = cube_coord_cp(t);
+    ret.epud = cube_coord_epud(t);
+    ret.epe = cube_coord_epe(t);
+
+    return ret;
+}
+
+int phase2_bound(p2coord_t c) {
+    return max(pt_cp_epe[c.cp * NEPE + c.epe], pt_epud_epe[c.epud * NEPE + c.epe]);
+}
+
+/* How many nodes a thread visits between two checks of the limits */
+#define CHECK_NODES 4096
+
+/* Stops the search, unless it was stopped before for another reason */
+static void stop_search(solve_shared_t &sh, solve_status_t status) {
+    lock_guard<mutex> guard(sh.lock);
+    if (!sh.stop.load()) {
+        sh.status = status;
+        sh.stop = true;
+    }
+}
+
+static void flush_nodes(search_t &st) {
+    solve_shared_t &sh = *st.sh;
+    int64_t n = sh.nodes += st.nodes;
+    st.nodes = 0;
+    if (sh.opts->max_nodes > 0 && n >= sh.opts->max_nodes)
+        stop_search(sh, SOLVE_NODE_LIMIT);
+    if (sh.opts->max_time > 0 && chrono::steady_clock::now() >= sh.deadline)
+        stop_search(sh, SOLVE_TIME_LIMIT);
+}
+
+/* Counts a node and returns true if the search must stop */
+static inline bool visit(search_t &st) {
+    if (++st.nodes == CHECK_NODES)
+        flush_nodes(st);
+    return st.sh->stop.load(memory_order_relaxed);
+}
+
+#ifdef SOLVE_STATS
+static double seconds_since(chrono::steady_clock::time_point t) {
+    return chrono::duration<double>(chrono::steady_clock::now() - t).count();
+}
+
+/* Adds the statistics of a thread to the shared ones and clears them */
+static void merge_stats(search_t &st) {
+    solve_shared_t &sh = *st.sh;
+    lock_guard<mutex> guard(sh.lock);
+    for (int p = 0; p < 2; p++) {
+        for (int d = 0; d <= LIMSOL; d++)
+            sh.stats.nodes[p][d] += st.stats.nodes[p][d];
+        sh.stats.cutoffs[p] += st.stats.cutoffs[p];
+        sh.stats.lookups[p] += st.stats.lookups[p];
+        sh.stats.time[p] += st.stats.time[p];
+    }
+    sh.stats.dr_leaves += st.stats.dr_leaves;
+    sh.stats.phase2_entries += st.stats.phase2_entries;
+    st.stats = solve_stats_t();
+}
+#endif
+
+/*
+ * The length of the best solution found so far is shared by all threads
+ * that work on the same cube, and every node is pruned against it.
+ */
+static void found_solution(search_t &st, int td) {
+    solve_shared_t &sh = *st.sh;
+    lock_guard<mutex> guard(sh.lock);
+    if (td >= sh.hb.load() || sh.stop.load())
+        return;
+    sh.best.assign(st.moves, st.moves + td);
+    sh.found = true;
+    sh.hb = td;
+    if (sh.opts->callback && !sh.opts->callback(sh.best)) {
+        sh.status = SOLVE_STOPPED;
+        sh.stop = true;
+    }
+}
+
+void phase2search(search_t &st, p2coord_t c, int d2, move_t last, move_t second_last, int td, int axis) {
+    if (visit(st)) {
+        return;
+    }
+    STATS(st.stats.nodes[1][td]++);
+    STATS(st.stats.lookups[1] += 2);
+    if (phase2_bound(c) > d2) {
+        STATS(st.stats.cutoffs[1]++);
+        return;
+    }
+    if (d2 == 0) {
+        found_solution(st, td);
+    } else if (td <= st.pd) {
         for (int i = 0; i < DRMOVES; i++) {
             if (notRedundantMove(drmoves[axis][i],last, second_last)) {
-                cube_t newcube = cube_move(c, drmoves[axis][i]);
-                sol_t new_s = s;
-                new_s.push_back(drmoves[axis][i]);
-                hb = min(hb, phase2search(newcube, d2 - 1, new_s, drmoves[axis][i], last, td+1, hb, axis, pd));
+                int m = drconj[axis][i];
+                p2coord_t newc = { mt_cp[c.cp][m], mt_epud[c.epud][m], mt_epe[c.epe][m] };
+                st.moves[td] = drmoves[axis][i];
+                phase2search(st, newc, d2 - 1, drmoves[axis][i], last, td+1, axis);
             }
         }
     }
-    return hb;
 }
 
-int phase1search(cube_t c, int d1, sol_t s, move_t last, move_t second_last, int td, int hb, int pd) {
+void phase1search(search_t &st, p1coord_t c, int d1, move_t last, move_t second_last, int td) {
+    int axis;
+    if (visit(st)) {
+        return;
+    }
+    STATS(st.stats.nodes[0][td]++);
+    STATS(st.stats.lookups[0] += NAXES);
+    int h = phase1_bound(c, &axis);
+    if (h > d1) {
+        STATS(st.stats.cutoffs[0]++);
+        return;
+    }
     if (d1 == 0) {
-        if (dr(c)) {
-            int axis = 0;
-            if (drrl(c)) {
-                axis = 1;
-            } else if (drfb(c)) {
-                axis = 2;
+        if (h == 0) {
+            STATS(st.stats.dr_leaves++);
+            STATS(auto start = chrono::steady_clock::now());
+            cube_t dr = st.root;
+            for (int i = 0; i < td; i++)
+                dr = cube_move(dr, st.moves[i]);
+            p2coord_t p2 = phase2_coord(dr, axis);
+            for (int i = phase2_bound(p2); i < st.sh->hb.load()-td; i++) {
+                STATS(st.stats.phase2_entries++);
+                phase2search(st, p2, i, last, second_last, td, axis);
             }
-            for (int i = 0; i < hb-td; i++) {      
-                cube_t nc = c;
-                hb = min(hb,phase2search(nc, i, s, last, second_last, td, hb, axis, pd));
-            }
-            return hb;
+            STATS(st.stats.time[1] += seconds_since(start));
         }
-        return INT_MAX;
-    } else if (d1 > 0 && td <= pd) {
+    } else if (d1 > 0 && td <= st.pd) {
         for (int i = 0; i < MOVES; i++) {
             if (notRedundantMove(moves[i], last, second_last)) {
-                cube_t newcube = cube_move(c, moves[i]);
-                sol_t new_s = s;
-                new_s.push_back(moves[i]);
-                hb = min(hb, phase1search(newcube, d1 - 1, new_s, moves[i], last, td+1, hb, pd));
+                p1coord_t newc = phase1_move(c, i);
+                st.moves[td] = moves[i];
+                phase1search(st, newc, d1 - 1, moves[i], last, td+1);
             }
         }
     }
-    return hb;
 }
 
-sol_t twoPhase(cube_t c) {
-    sol_t solution;
-    int hb = LIMSOL;
-    for (int pd = 0; pd < hb; pd++) {
-        // printf("phase depth: %d\n", pd);
-        for(int d = 0; d < pd; d++) {
-            hb = min(hb, phase1search(c, d, solution, move_t(), move_t(), 0, hb, pd));
+/*
+ * Thread pool with one task queue per worker. A worker takes tasks from
+ * the back of its own queue and, when that is empty, steals from the front
+ * of the others. run() spreads a batch of tasks over the queues and waits
+ * until all of them are done.
+ */
+class WorkPool {
+public:
+    WorkPool(int n) : queues(n) {
+        for (int i = 0; i < n; i++)
+            queues[i].reset(new Queue);
+        for (int i = 0; i < n; i++)
+            threads.push_back(thread(&WorkPool::work, this, i));
+    }
+
+    ~WorkPool() {
+        {
+            lock_guard<mutex> guard(lock);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto &t : threads)
+            t.join();
+    }
+
+    void run(vector<function<void()>> &tasks) {
+        unique_lock<mutex> guard(lock);
+        pending += tasks.size();
+        for (size_t i = 0; i < tasks.size(); i++) {
+            Queue &q = *queues[i % queues.size()];
+            lock_guard<mutex> qguard(q.lock);
+            /* Counted before a worker can take it, so queued never wraps */
+            queued++;
+            q.tasks.push_back(move(tasks[i]));
         }
+        wake.notify_all();
+        idle.wait(guard, [this] { return pending == 0; });
     }
-    return solution;
-}
\ No newline at end of file
+
+private:
+    struct Queue {
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<Queue>> queues;
+    vector<thread> threads;
+    mutex lock;
+    condition_variable wake, idle;
+    size_t pending = 0;
+    atomic<size_t> queued{0};
+    bool stop = false;
+
+    bool take(int id, function<void()> &task) {
+        int n = queues.size();
+        for (int i = 0; i < n; i++) {
+            Queue &q = *queues[(id + i) % n];
+            lock_guard<mutex> guard(q.lock);
+            if (q.tasks.empty())
+                continue;
+            if (i == 0) {
+                task = move(q.tasks.back());
+                q.tasks.pop_back();
+            } else {
+                task = move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+            queued--;
+            return true;
+        }
+        return false;
+    }
+
+    void work(int id) {
+        function<void()> task;
+        for (;;) {
+            if (take(id, task)) {
+                task();
+                lock_guard<mutex> guard(lock);
+                if (--pending == 0)
+                    idle.notify_all();
+                continue;
+            }
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [this] { return stop || queued > 0; });
+            if (stop)
+                return;
+        }
+    }
+};
+
+/*
+ * Root splitting: expand the top splitdepth levels of the phase 1 tree in
+ * the same order as phase1search, and make a task for each node left. Each
+ * task gets its own copy of the search state and prunes its own root.
+ */
+static void split(search_t &st, p1coord_t c, int d1, move_t last, move_t second_last, int td, int splitdepth, vector<function<void()>> &tasks) {
+    int axis;
+    if (td > st.pd) {
+        return;
+    }
+    if (splitdepth == 0) {
+        tasks.push_back([st, c, d1, last, second_last, td]() mutable {
+            st.nodes = 0;
+            STATS(st.stats = solve_stats_t());
+            STATS(auto start = chrono::steady_clock::now());
+            phase1search(st, c, d1, last, second_last, td);
+            STATS(st.stats.time[0] += seconds_since(start));
+            STATS(merge_stats(st));
+            flush_nodes(st);
+        });
+        return;
+    }
+    STATS(st.stats.nodes[0][td]++);
+    STATS(st.stats.lookups[0] += NAXES);
+    if (phase1_bound(c, &axis) > d1) {
+        STATS(st.stats.cutoffs[0]++);
+        return;
+    }
+    for (int i = 0; i < MOVES; i++) {
+        if (notRedundantMove(moves[i], last, second_last)) {
+            st.moves[td] = moves[i];
+            split(st, phase1_move(c, i), d1 - 1, moves[i], last, td+1, splitdepth - 1, tasks);
+        }
+    }
+}
+
+solve_result_t solve(cube_t c, const solve_options_t &opts) {
+    solve_result_t ret;
+    ret.nodes = 0;
+    ret.stats = solve_stats_t();
+    if (!cube_solvable(c)) {
+        ret.status = SOLVE_UNSOLVABLE;
+        return ret;
+    }
+
+    solve_shared_t sh;
+    sh.opts = &opts;
+    sh.hb = min(opts.max_length, LIMSOL) + 1;
+    sh.stop = false;
+    sh.nodes = 0;
+    sh.found = false;
+    sh.stats = solve_stats_t();
+    STATS(auto start = chrono::steady_clock::now());
+    init_phase1_tables();
+    init_phase2_tables();
+    /* The time limit is for the search, not for loading the tables */
+    sh.deadline = chrono::steady_clock::now() +
+        chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(opts.max_time));
+    search_t st;
+    st.root = c;
+    st.sh = &sh;
+    st.nodes = 0;
+    STATS(st.stats = solve_stats_t());
+    p1coord_t p1 = phase1_coord(c);
+    int nthreads = opts.nthreads;
+    unique_ptr<WorkPool> pool(nthreads > 1 ? new WorkPool(nthreads) : NULL);
+    for (st.pd = 0; st.pd < sh.hb && !sh.stop; st.pd++) {
+        for(int d = 0; d < st.pd && !sh.stop; d++) {
+            int splitdepth = nthreads > 16 ? 3 : 2;
+            if (pool == NULL || d < splitdepth) {
+                STATS(auto t = chrono::steady_clock::now());
+                phase1search(st, p1, d, NOMOVE, NOMOVE, 0);
+                STATS(st.stats.time[0] += seconds_since(t));
+            } else {
+                vector<function<void()>> tasks;
+                split(st, p1, d, NOMOVE, NOMOVE, 0, splitdepth, tasks);
+                pool->run(tasks);
+            }
+        }
+    }
+    flush_nodes(st);
+    STATS(merge_stats(st));
+    /* Phase 1 time was measured with the phase 2 searches inside it */
+    STATS(sh.stats.time[0] -= sh.stats.time[1]);
+    STATS(sh.stats.wall = seconds_since(start));
+
+    ret.status = sh.stop ? sh.status : sh.found ? SOLVE_DONE : SOLVE_NO_SOLUTION;
+    ret.solution = sh.best;
+    ret.nodes = sh.nodes;
+    ret.stats = sh.stats;
+    return ret;
+}
+
+void print_solve_stats(FILE *f, const solve_stats_t &stats) {
+    for (int p = 0; p < 2; p++) {
+        fprintf(f, "phase %d nodes by depth:", p + 1);
+        for (int d = 0; d <= LIMSOL; d++)
+            fprintf(f, " %lld", (long long)stats.nodes[p][d]);
+        fprintf(f, "\nphase %d cutoffs: %lld, lookups: %lld, time: %.3fs\n", p + 1,
+            (long long)stats.cutoffs[p], (long long)stats.lookups[p], stats.time[p]);
+    }
+    fprintf(f, "DR leaves: %lld, phase 2 searches: %lld, wall time: %.3fs\n",
+        (long long)stats.dr_leaves, (long long)stats.phase2_entries, stats.wall);
+}
+
+sol_t twoPhase(cube_t c, int nthreads, bool verbose) {
+    solve_options_t opts;
+    opts.nthreads = nthreads;
+    if (verbose) {
+        opts.callback = [](const sol_t &s) {
+            print_solution_singmaster(s, true);
+            return true;
+        };
+    }
+    return solve(c, opts).solution;
+}
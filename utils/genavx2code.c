@@ -0,0 +1,55 @@
+/*
+ * Prints the move and transformation tables in the padded layout used by
+ * the AVX2 backend: corners in bytes 0-7, edges in bytes 16-27.
+ * Compile from the utils directory with:
+ * cc -DCUBE_PORTABLE genavx2code.c -o genavx2code
+ */
+
+#include "../cube.c"
+
+#include <stdio.h>
+
+static void
+printavx2(cube_t c, const char *indent)
+{
+	int i;
+
+	printf("%s", indent);
+	for (i = 0; i < 8; i++)
+		printf("%u, ", c.corner[i]);
+	printf("0, 0, 0, 0, 0, 0, 0, 0,\n%s", indent);
+	for (i = 0; i < 12; i++)
+		printf("%u, ", c.edge[i]);
+	printf("0, 0, 0, 0\n");
+}
+
+int
+main(void)
+{
+	move_t m;
+	trans_t t;
+
+	printf("_static uint8_t move_table_avx2[][32] = {\n");
+	for (m = 0; m < 18; m++) {
+		printf("\t[%c%s] = {\n", movestr[m][0],
+		    movestr[m][1] == '\'' ? "3" : movestr[m] + 1);
+		printavx2(move_table[m], "\t\t");
+		printf("\t},\n");
+	}
+	printf("};\n\n");
+
+	printf("_static uint8_t trans_table_avx2[][2][32] = {\n");
+	for (t = 0; t < 48; t++) {
+		printf("\t[%.2s%c] = {\n", transstr[t] + 9, transstr[t][0]);
+		printf("\t\t[NORMAL] = {\n");
+		printavx2(trans_table[t][NORMAL], "\t\t\t");
+		printf("\t\t},\n");
+		printf("\t\t[INVERSE] = {\n");
+		printavx2(trans_table[t][INVERSE], "\t\t\t");
+		printf("\t\t}\n");
+		printf("\t},\n");
+	}
+	printf("};\n");
+
+	return 0;
+}
@@ -0,0 +1,58 @@
+/*
+ * Prints the move and transformation tables in the word-packed layout used
+ * by the SWAR backend. Compile from the utils directory with:
+ * cc -DCUBE_PORTABLE genswarcode.c -o genswarcode
+ */
+
+#include "../cube.c"
+
+#include <stdio.h>
+
+static void
+printswar(cube_t c, const char *indent)
+{
+	int i;
+	uint64_t corner, edge[2] = {0};
+
+	for (i = 0, corner = 0; i < 8; i++)
+		corner |= (uint64_t)c.corner[i] << (8*i);
+	for (i = 0; i < 12; i++)
+		edge[i/8] |= (uint64_t)c.edge[i] << (8*(i%8));
+
+	printf("%s.corner = UINT64_C(0x%016" PRIX64 "),\n", indent, corner);
+	printf("%s.edge = {\n", indent);
+	printf("%s\tUINT64_C(0x%016" PRIX64 "),\n", indent, edge[0]);
+	printf("%s\tUINT64_C(0x%016" PRIX64 ")\n", indent, edge[1]);
+	printf("%s}\n", indent);
+}
+
+int
+main(void)
+{
+	move_t m;
+	trans_t t;
+
+	printf("_static cube_swar_t move_table_swar[] = {\n");
+	for (m = 0; m < 18; m++) {
+		printf("\t[%c%s] = {\n", movestr[m][0],
+		    movestr[m][1] == '\'' ? "3" : movestr[m] + 1);
+		printswar(move_table[m], "\t\t");
+		printf("\t},\n");
+	}
+	printf("};\n\n");
+
+	printf("_static cube_swar_t trans_table_swar[][2] = {\n");
+	for (t = 0; t < 48; t++) {
+		printf("\t[%.2s%c] = {\n", transstr[t] + 9, transstr[t][0]);
+		printf("\t\t[NORMAL] = {\n");
+		printswar(trans_table[t][NORMAL], "\t\t\t");
+		printf("\t\t},\n");
+		printf("\t\t[INVERSE] = {\n");
+		printswar(trans_table[t][INVERSE], "\t\t\t");
+		printf("\t\t}\n");
+		printf("\t},\n");
+	}
+	printf("};\n");
+
+	return 0;
+}